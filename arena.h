@@ -0,0 +1,127 @@
+/**
+ * File              : arena.h
+ * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
+ * Date              : 17.10.2026
+ * Last Modified Date: 17.10.2026
+ * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
+ */
+
+/**
+ * Simple arena allocator - memory is taken from big blocks
+ * and released at once
+ * USAGE:
+ * struct arena a;
+ * arena_init(&a, 0);
+ * char *s = arena_strdup(&a, "Hello");
+ * arena_reset(&a); //reuse memory
+ * arena_free(&a);
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_BLOCK_SIZE 16384
+#define ARENA_ALIGN      8
+
+/* block of memory */
+struct arena_block {
+	struct arena_block *next;
+	size_t size;  //size of data
+	size_t used;  //used size of data
+};
+
+/* arena structure */
+struct arena {
+	struct arena_block *head;       //current block
+	size_t              block_size; //size of new block
+};
+
+/* init arena - block_size 0 for default */
+static void arena_init(struct arena *a, size_t block_size);
+
+/* allocate aligned memory - return NULL on error */
+static void *arena_alloc(struct arena *a, size_t size);
+
+/* copy len bytes of string with null char */
+static char *arena_strndup(struct arena *a, const char *s, size_t len);
+
+/* copy null-terminated string */
+static char *arena_strdup(struct arena *a, const char *s);
+
+/* release all allocations - keep one block for reuse */
+static void arena_reset(struct arena *a);
+
+/* free all memory of arena */
+static void arena_free(struct arena *a);
+
+/* IMPLIMATION */
+
+void arena_init(struct arena *a, size_t block_size)
+{
+	a->head = NULL;
+	a->block_size = block_size ? block_size : ARENA_BLOCK_SIZE;
+}
+
+void *arena_alloc(struct arena *a, size_t size)
+{
+	struct arena_block *b = a->head;
+
+	size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+	if (!b || b->size - b->used < size){
+		// new block - big allocations get own block
+		size_t n = size > a->block_size ? size : a->block_size;
+		b = (struct arena_block *)malloc(sizeof(struct arena_block) + n);
+		if (!b)
+			return NULL;
+		b->size = n;
+		b->used = 0;
+		b->next = a->head;
+		a->head = b;
+	}
+	b->used += size;
+	return (char *)(b + 1) + b->used - size;
+}
+
+char *arena_strndup(struct arena *a, const char *s, size_t len)
+{
+	char *p = (char *)arena_alloc(a, len + 1);
+	if (!p)
+		return NULL;
+	memcpy(p, s, len);
+	p[len] = 0;
+	return p;
+}
+
+char *arena_strdup(struct arena *a, const char *s)
+{
+	return arena_strndup(a, s, strlen(s));
+}
+
+void arena_reset(struct arena *a)
+{
+	struct arena_block *b = a->head;
+	if (!b)
+		return;
+
+	// keep oldest block for reuse
+	while (b->next) {
+		struct arena_block *next = b->next;
+		free(b);
+		b = next;
+	}
+	b->used = 0;
+	a->head = b;
+}
+
+void arena_free(struct arena *a)
+{
+	while (a->head) {
+		struct arena_block *next = a->head->next;
+		free(a->head);
+		a->head = next;
+	}
+}
+
+#endif /* ifndef ARENA_H_ */
@@ -2,7 +2,7 @@
  * File              : cYandexDisk.c
  * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
  * Date              : 03.05.2022
- * Last Modified Date: 24.04.2026
+ * Last Modified Date: 16.10.2026
  * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
  */
 #include "cYandexDisk.h"
@@ -12,20 +12,31 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <limits.h>
 #include "cJSON.h"
 #include "uuid4.h"
+#include "sha256.h"
+#include "md5.h"
+#include "jstream.h"
+#include "treeindex.h"
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <pthread.h>
 #include <time.h>
 #include "alloc.h"
+#include "arena.h"
 #include "log.h"
 #include "str.h"
 
 #ifdef _WIN32
 #include <windows.h>
+#include <malloc.h>
+#include <sys/timeb.h>
 #else
 #include <unistd.h>
+#include <strings.h>
 #endif
 
 //add strptime
@@ -35,6 +46,27 @@
 #define VERIFY_SSL 0
 
 #define YD_ANSWER_LIMIT 20
+#define YD_POOL_SIZE 8
+#define YD_CLIENTS_CACHE 8
+#define YD_OPERATION_INTERVAL 250
+#define YD_OPERATION_INTERVAL_MAX 8000
+#define YD_OPERATION_TICK 100
+#define YD_DOWNLOAD_CHUNK (8 * 1024 * 1024)
+#define YD_RANGE_RETRIES 3
+#define YD_TRANSFER_WORKERS 4
+#define YD_LS_PREFETCH 4
+#define YD_WALK_CONCURRENCY 8
+#define YD_WALK_PAGE_SIZE 100
+#define YD_STAT_REQUESTS 8
+#define YD_CHANGES_LIMIT 100
+#define YD_CHANGES_LIMIT_MAX 10000
+#define YD_CACHE_SIZE (1024 * 1024)
+#define YD_CACHE_BUCKETS 256
+#define YD_JSON_BLOCK 4096
+#define YD_JSON_BUCKETS 256
+// fields of resource to fill c_yd_file_t
+#define YD_FILE_FIELDS "name,type,path,mime_type,size,preview,public_key,"\
+	"public_url,modified,created,md5,sha256"
 
 char * 
 c_yandex_disk_url_to_ask_for_verification_code(
@@ -193,11 +225,11 @@ void c_yandex_disk_url_to_ask_for_verification_code_for_user(
 				cJSON *error_description = cJSON_GetObjectItem(json, "error_description");
 				if (!error_description) {
 					callback(user_data, NULL, NULL, NULL, 0, 0, STR("cYandexDisk: unknown error!")); //no error code in JSON answer
-					cJSON_free(json);
+					cJSON_Delete(json);
 					return;
 				}
 				callback(user_data, NULL, NULL, NULL, 0, 0, STR("cYandexDisk: %s", error_description->valuestring)); //no error code in JSON answer
-				cJSON_free(json);
+				cJSON_Delete(json);
 				return;
 			}
 			//OK - we have a code
@@ -209,7 +241,7 @@ void c_yandex_disk_url_to_ask_for_verification_code_for_user(
 					cJSON_GetObjectItem(json, "expires_in")->valueint, 
 					NULL
 					);
-			cJSON_free(json);
+			cJSON_Delete(json);
 		}	
 	}
 
@@ -302,16 +334,16 @@ void c_yandex_disk_get_token_from_user(
 					cJSON *error_description = cJSON_GetObjectItem(json, "error_description");
 					if (!error_description) {
 						callback(user_data, NULL, 0, NULL, STR("cYandexDisk: unknown error!")); //no error code in JSON answer
-						cJSON_free(json);
+						cJSON_Delete(json);
 						continue;
 					}
 					callback(user_data, NULL, 0, NULL, STR("cYandexDisk: %s", error_description->valuestring)); //no error code in JSON answer
-					cJSON_free(json);
+					cJSON_Delete(json);
 					continue;
 				}
 				//OK - we have a token
 				callback(user_data, access_token->valuestring, cJSON_GetObjectItem(json, "expires_in")->valueint, cJSON_GetObjectItem(json, "refresh_token")->valuestring, NULL);
-				cJSON_free(json);
+				cJSON_Delete(json);
 				break;
 			}	
 #ifdef _WIN32
@@ -402,20 +434,92 @@ c_yandex_disk_get_token(
 				cJSON *error_description = cJSON_GetObjectItem(json, "error_description");
 				if (!error_description) {
 					callback(user_data, NULL, 0, NULL, STR("cYandexDisk: unknown error!")); //no error code in JSON answer
-					cJSON_free(json);
+					cJSON_Delete(json);
 					return;
 				}
 				callback(user_data, NULL, 0, NULL, STR("cYandexDisk: %s", error_description->valuestring)); //no error code in JSON answer
-				cJSON_free(json);
+				cJSON_Delete(json);
 				return;
 			}
 			//OK - we have a token
 			callback(user_data, access_token->valuestring, cJSON_GetObjectItem(json, "expires_in")->valueint, cJSON_GetObjectItem(json, "refresh_token")->valuestring, NULL);
-			cJSON_free(json);
+			cJSON_Delete(json);
 		}	
 	}
 }
 
+/* DNS cache and TLS sessions shared by all curl handles of
+ * library - new transfer threads start with resolved hosts
+ * and resumed TLS sessions. Connections are not shared: 
+ * handles run at once in different threads, connections are
+ * reused by pool and by engine multi */
+static pthread_mutex_t _c_yd_share_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t _c_yd_share_locks[CURL_LOCK_DATA_LAST];
+static CURLSH *_c_yd_share = NULL;
+
+static void _c_yd_share_lockfunc(
+		CURL *curl, curl_lock_data data, curl_lock_access access,
+		void *userptr)
+{
+	(void)curl;
+	(void)access;
+	(void)userptr;
+	pthread_mutex_lock(&_c_yd_share_locks[data]);
+}
+
+static void _c_yd_share_unlockfunc(
+		CURL *curl, curl_lock_data data, void *userptr)
+{
+	(void)curl;
+	(void)userptr;
+	pthread_mutex_unlock(&_c_yd_share_locks[data]);
+}
+
+static CURLSH *_c_yd_share_new(void)
+{
+	int i;
+	CURLSH *share = curl_share_init();
+	if (!share)
+		return NULL;
+
+	for (i = 0; i < CURL_LOCK_DATA_LAST; ++i)
+		pthread_mutex_init(&_c_yd_share_locks[i], NULL);
+
+	curl_share_setopt(share, CURLSHOPT_LOCKFUNC, _c_yd_share_lockfunc);
+	curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, _c_yd_share_unlockfunc);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+#if LIBCURL_VERSION_NUM >= 0x071700
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#endif
+	return share;
+}
+
+/* attach shared caches to curl handle */
+static void _c_yd_share_setopt(CURL *curl)
+{
+	pthread_mutex_lock(&_c_yd_share_lock);
+	if (!_c_yd_share)
+		_c_yd_share = _c_yd_share_new();
+	if (_c_yd_share)
+		curl_easy_setopt(curl, CURLOPT_SHARE, _c_yd_share);
+	pthread_mutex_unlock(&_c_yd_share_lock);
+}
+
+/* free shared caches if no curl handle use them */
+static void _c_yd_share_cleanup(void)
+{
+	int i;
+	pthread_mutex_lock(&_c_yd_share_lock);
+	if (_c_yd_share &&
+			curl_share_cleanup(_c_yd_share) == CURLSHE_OK)
+	{
+		_c_yd_share = NULL;
+		for (i = 0; i < CURL_LOCK_DATA_LAST; ++i)
+			pthread_mutex_destroy(&_c_yd_share_locks[i]);
+	}
+	pthread_mutex_unlock(&_c_yd_share_lock);
+}
+
 int curl_download_file(FILE *fp, const char * url, void * user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow)) 
 {
 	
@@ -432,6 +536,7 @@ int curl_download_file(FILE *fp, const char * url, void * user_data, void (*call
 		/* example.com is redirected, so we tell libcurl to follow redirection */
 		curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);		
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, VERIFY_SSL);		
+		_c_yd_share_setopt(curl);
 		if (progress_callback) {
 #if LIBCURL_VERSION_NUM < 0x073200
 			curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, clientp);
@@ -471,6 +576,251 @@ int curl_download_file(FILE *fp, const char * url, void * user_data, void (*call
     return 0;
 }
 
+#ifndef _WIN32
+/* byte range of parallel download */
+struct curl_range {
+	CURL      *curl;
+	int        fd;
+	curl_off_t offset;    //next byte to write
+	curl_off_t end;       //last byte of range
+	curl_off_t *now;      //downloaded bytes of all ranges
+	int        retries;
+};
+
+static size_t curl_range_writefunc(
+		char *ptr, size_t size, size_t nmemb, struct curl_range *r)
+{
+	size_t len = size * nmemb, done = 0;
+	long code = 0;
+
+	// server ignored range request
+	curl_easy_getinfo(r->curl, CURLINFO_RESPONSE_CODE, &code);
+	if (code != 206 || r->offset + (curl_off_t)len > r->end + 1)
+		return 0;
+
+	while (done < len) {
+		ssize_t n = pwrite(r->fd, ptr + done, len - done, r->offset);
+		if (n < 0)
+			return 0;
+		done += n;
+		r->offset += n;
+	}
+	*r->now += len;
+	return len;
+}
+
+static void curl_range_setopt(
+		struct curl_range *r, const char *url)
+{
+	char range[64];
+	snprintf(range, sizeof(range), 
+			"%" CURL_FORMAT_CURL_OFF_T "-%" CURL_FORMAT_CURL_OFF_T, 
+			r->offset, r->end);
+	curl_easy_reset(r->curl);
+	curl_easy_setopt(r->curl, CURLOPT_URL, url);
+	curl_easy_setopt(r->curl, CURLOPT_RANGE, range);
+	curl_easy_setopt(r->curl, CURLOPT_PRIVATE, r);
+	curl_easy_setopt(r->curl, CURLOPT_WRITEFUNCTION, curl_range_writefunc);
+	curl_easy_setopt(r->curl, CURLOPT_WRITEDATA, r);
+	curl_easy_setopt(r->curl, CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(r->curl, CURLOPT_SSL_VERIFYPEER, VERIFY_SSL);
+	_c_yd_share_setopt(r->curl);
+}
+
+static size_t curl_range_headerfunc(
+		char *ptr, size_t size, size_t nmemb, bool *accept_ranges)
+{
+	size_t len = size * nmemb;
+	if (len > 20 && strncasecmp(ptr, "Accept-Ranges:", 14) == 0 && 
+			strstr(ptr + 14, "bytes"))
+		*accept_ranges = true;
+	return len;
+}
+
+/* get file size and url after redirects - return -1 if
+ * server does not support range requests */
+static curl_off_t curl_range_head(const char *url, char **href)
+{
+	CURL *curl;
+	CURLcode res;
+	curl_off_t size = -1;
+	bool accept_ranges = false;
+	char *effective_url = NULL;
+
+	curl = curl_easy_init();
+	if (!curl)
+		return -1;
+
+	curl_easy_setopt(curl, CURLOPT_URL, url);
+	curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curl_range_headerfunc);
+	curl_easy_setopt(curl, CURLOPT_HEADERDATA, &accept_ranges);
+	curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, VERIFY_SSL);
+	_c_yd_share_setopt(curl);
+
+	res = curl_easy_perform(curl);
+	if (res == CURLE_OK && accept_ranges) {
+#if LIBCURL_VERSION_NUM >= 0x073700
+		curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &size);
+#else
+		double length;
+		curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length);
+		size = (curl_off_t)length;
+#endif
+		curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &effective_url);
+		*href = strdup(effective_url ? effective_url : url);
+		if (!*href)
+			size = -1;
+	}
+	curl_easy_cleanup(curl);
+	return size;
+}
+#endif
+
+int curl_download_file_ranges(FILE *fp, const char * url, int streams, size_t chunk_size, void * user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+#ifdef _WIN32
+	// no pwrite - download in one stream
+	return curl_download_file(fp, url, user_data, callback, clientp, progress_callback);
+#else
+	CURLM *multi;
+	CURLMsg *msg;
+	CURL **idle;
+	struct curl_range *ranges;
+	curl_off_t size, now = 0;
+	char *href = NULL;
+	char error[BUFSIZ] = "";
+	int fd, nranges, next = 0, running = 0, nidle = 0, i, left;
+
+	if (chunk_size < 1)
+		chunk_size = YD_DOWNLOAD_CHUNK;
+
+	size = streams > 1 ? curl_range_head(url, &href) : -1;
+	if (size <= (curl_off_t)chunk_size){
+		free(href);
+		return curl_download_file(fp, url, user_data, callback, clientp, progress_callback);
+	}
+
+	// preallocate file
+	fflush(fp);
+	fd = fileno(fp);
+	if (ftruncate(fd, size)){
+		free(href);
+		if (callback)
+			callback(fp, 0, user_data, STR("cYandexDisk: can't allocate file: %s", strerror(errno)));
+		fclose(fp);
+		return -1;
+	}
+
+	nranges = (int)((size + chunk_size - 1) / chunk_size);
+	if (streams > nranges)
+		streams = nranges;
+	ranges = MALLOC(sizeof(struct curl_range) * nranges);
+	idle = MALLOC(sizeof(CURL *) * streams);
+	multi = curl_multi_init();
+	if (!ranges || !idle || !multi){
+		free(href);
+		free(ranges);
+		free(idle);
+		if (multi)
+			curl_multi_cleanup(multi);
+		if (callback)
+			callback(fp, 0, user_data, STR("cYandexDisk: %s", "can't allocate memory"));
+		fclose(fp);
+		return -1;
+	}
+	for (i = 0; i < nranges; ++i) {
+		ranges[i].curl = NULL;
+		ranges[i].fd = fd;
+		ranges[i].offset = (curl_off_t)i * chunk_size;
+		ranges[i].end = ranges[i].offset + chunk_size - 1;
+		if (ranges[i].end >= size)
+			ranges[i].end = size - 1;
+		ranges[i].now = &now;
+		ranges[i].retries = 0;
+	}
+
+	while (!*error) {
+		// keep streams busy
+		while (running < streams && next < nranges) {
+			struct curl_range *r = &ranges[next];
+			r->curl = nidle > 0 ? idle[--nidle] : curl_easy_init();
+			if (!r->curl){
+				strcpy(error, "can't init curl");
+				break;
+			}
+			curl_range_setopt(r, href);
+			curl_multi_add_handle(multi, r->curl);
+			running++;
+			next++;
+		}
+		if (*error)
+			break;
+
+		curl_multi_perform(multi, &left);
+		while ((msg = curl_multi_info_read(multi, &left))) {
+			struct curl_range *r;
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+			curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&r);
+			curl_multi_remove_handle(multi, r->curl);
+			if (r->offset > r->end){
+				// range is complete
+				idle[nidle++] = r->curl;
+				r->curl = NULL;
+				running--;
+			} else if (r->retries++ < YD_RANGE_RETRIES){
+				// continue from last written byte
+				curl_range_setopt(r, href);
+				curl_multi_add_handle(multi, r->curl);
+			} else {
+				snprintf(error, sizeof(error), 
+						"curl_easy_perform() failed: %d", msg->data.result);
+			}
+		}
+
+		if (!*error && progress_callback && 
+				progress_callback(clientp, (double)size, (double)now, 0, 0))
+			strcpy(error, "download aborted");
+		
+		if (running == 0 && next == nranges)
+			break;
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+		curl_multi_poll(multi, NULL, 0, 1000, NULL);
+#else
+		curl_multi_wait(multi, NULL, 0, 100, NULL);
+#endif
+	}
+
+	for (i = 0; i < nranges; ++i) {
+		if (ranges[i].curl){
+			curl_multi_remove_handle(multi, ranges[i].curl);
+			curl_easy_cleanup(ranges[i].curl);
+		}
+	}
+	while (nidle > 0)
+		curl_easy_cleanup(idle[--nidle]);
+	curl_multi_cleanup(multi);
+	free(idle);
+	free(ranges);
+	free(href);
+
+	// file is closed after callback - callback gets file of caller
+	if (*error){
+		if (callback)
+			callback(fp, 0, user_data, STR("cYandexDisk: %s", error));
+		fclose(fp);
+		return -1;
+	}
+	if (callback)
+		callback(fp, size, user_data, NULL);
+	fclose(fp);
+	return 0;
+#endif
+}
+
 size_t curl_download_data_writefunc(
 		void *data, size_t size, size_t nmemb, struct str *s)
 {
@@ -497,6 +847,7 @@ size_t curl_download_data(const char * url, void * user_data, void (*callback)(v
 		/* example.com is redirected, so we tell libcurl to follow redirection */
 		curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);		
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, VERIFY_SSL);		
+		_c_yd_share_setopt(curl);
 		if (progress_callback) {
 #if LIBCURL_VERSION_NUM < 0x073200
 			curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, clientp);
@@ -514,7 +865,6 @@ size_t curl_download_data(const char * url, void * user_data, void (*callback)(v
 		if(res != CURLE_OK) {
 			if (callback)
 				callback(NULL, 0, user_data, STR("cYandexDisk: curl_easy_perform() failed: %d\n", res));
-			curl_easy_cleanup(curl);
 			////return -1;
 		} else {
 			/* now extract transfer info */
@@ -534,6 +884,155 @@ size_t curl_download_data(const char * url, void * user_data, void (*callback)(v
     return s.len;
 }
 
+/* streaming download */
+struct c_yd_stream {
+	pthread_mutex_t lock;
+	CURLM *multi;
+	CURL  *curl;
+	bool   paused;    //callback returned C_YD_STREAM_PAUSE
+	bool   resume;    //c_yd_stream_resume called while paused
+	bool   in_callback; //callback is running - it may pause
+	bool   stopped;   //callback returned error
+	size_t size;      //delivered bytes
+	void  *user_data;
+	int  (*callback)(c_yd_stream_t *stream, const void *data, size_t size, void *user_data, const char *error);
+};
+
+void c_yd_stream_resume(c_yd_stream_t *stream)
+{
+	pthread_mutex_lock(&stream->lock);
+	// resume of running stream is ignored - resume from
+	// callback that returns pause is kept
+	if (stream->paused || stream->in_callback)
+		stream->resume = true;
+	pthread_mutex_unlock(&stream->lock);
+#if LIBCURL_VERSION_NUM >= 0x074400
+	curl_multi_wakeup(stream->multi);
+#endif
+}
+
+static size_t curl_stream_writefunc(
+		char *ptr, size_t size, size_t nmemb, c_yd_stream_t *s)
+{
+	size_t len = size * nmemb;
+	int ret;
+
+	pthread_mutex_lock(&s->lock);
+	s->in_callback = true;
+	s->resume = false;
+	pthread_mutex_unlock(&s->lock);
+
+	ret = s->callback(s, ptr, len, s->user_data, NULL);
+	
+	pthread_mutex_lock(&s->lock);
+	s->in_callback = false;
+	if (ret == C_YD_STREAM_PAUSE){
+		// chunk is delivered again after resume - resume
+		// made while callback was running is kept
+		s->paused = true;
+		pthread_mutex_unlock(&s->lock);
+		return CURL_WRITEFUNC_PAUSE;
+	}
+	s->resume = false;
+	pthread_mutex_unlock(&s->lock);
+	if (ret){
+		s->stopped = true;
+		return 0;
+	}
+	s->size += len;
+	return len;
+}
+
+int curl_download_stream(const char * url, void * user_data, int (*callback)(c_yd_stream_t *stream, const void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	c_yd_stream_t s;
+	CURLMsg *msg;
+	CURLcode res = CURLE_OK;
+	int running = 1, left, ret = 0;
+	bool resume;
+
+	memset(&s, 0, sizeof(s));
+	s.curl = curl_easy_init();
+	s.multi = curl_multi_init();
+	if (!s.curl || !s.multi){
+		if (s.curl)
+			curl_easy_cleanup(s.curl);
+		if (s.multi)
+			curl_multi_cleanup(s.multi);
+		callback(NULL, NULL, 0, user_data, "cYandexDisk: can't init curl");
+		return -1;
+	}
+	pthread_mutex_init(&s.lock, NULL);
+	s.user_data = user_data;
+	s.callback = callback;
+
+	curl_easy_setopt(s.curl, CURLOPT_URL, url);
+	curl_easy_setopt(s.curl, CURLOPT_WRITEFUNCTION, curl_stream_writefunc);
+	curl_easy_setopt(s.curl, CURLOPT_WRITEDATA, &s);
+	curl_easy_setopt(s.curl, CURLOPT_FOLLOWLOCATION, 1L);
+	// do not stream error page
+	curl_easy_setopt(s.curl, CURLOPT_FAILONERROR, 1L);
+	curl_easy_setopt(s.curl, CURLOPT_SSL_VERIFYPEER, VERIFY_SSL);
+	_c_yd_share_setopt(s.curl);
+	if (progress_callback) {
+#if LIBCURL_VERSION_NUM < 0x073200
+		curl_easy_setopt(s.curl, CURLOPT_PROGRESSDATA, clientp);
+		curl_easy_setopt(s.curl, CURLOPT_PROGRESSFUNCTION, progress_callback);
+		curl_easy_setopt(s.curl, CURLOPT_NOPROGRESS, 0);
+#else
+		curl_easy_setopt(s.curl, CURLOPT_XFERINFODATA, clientp);
+		curl_easy_setopt(s.curl, CURLOPT_XFERINFOFUNCTION, progress_callback);
+		curl_easy_setopt(s.curl, CURLOPT_NOPROGRESS, 0);
+#endif
+	}
+
+	// transfer in this thread - multi handle is used to 
+	// unpause transfer as soon as c_yd_stream_resume called
+	curl_multi_add_handle(s.multi, s.curl);
+	while (running) {
+		curl_multi_perform(s.multi, &running);
+		if (!running)
+			break;
+
+		pthread_mutex_lock(&s.lock);
+		resume = s.paused && s.resume;
+		if (resume){
+			s.resume = false;
+			s.paused = false;
+		}
+		pthread_mutex_unlock(&s.lock);
+		if (resume){
+			curl_easy_pause(s.curl, CURLPAUSE_CONT);
+			continue;
+		}
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+		curl_multi_poll(s.multi, NULL, 0, 1000, NULL);
+#else
+		curl_multi_wait(s.multi, NULL, 0, 100, NULL);
+#endif
+	}
+	while ((msg = curl_multi_info_read(s.multi, &left))) {
+		if (msg->msg == CURLMSG_DONE)
+			res = msg->data.result;
+	}
+	curl_multi_remove_handle(s.multi, s.curl);
+
+	if (s.stopped){
+		callback(&s, NULL, s.size, user_data, "cYandexDisk: download stopped");
+		ret = -1;
+	} else if (res != CURLE_OK){
+		callback(&s, NULL, s.size, user_data, STR("cYandexDisk: curl_easy_perform() failed: %d", res));
+		ret = -1;
+	} else 
+		callback(&s, NULL, s.size, user_data, NULL);
+
+	curl_easy_cleanup(s.curl);
+	curl_multi_cleanup(s.multi);
+	pthread_mutex_destroy(&s.lock);
+	return ret;
+}
+
 size_t curl_upload_file_readfunc(char *ptr, size_t size, size_t nmemb, void *userdata)
 {
 	FILE *readhere = (FILE *)userdata;
@@ -581,6 +1080,7 @@ int curl_upload_file(FILE *fp, const char * url, void *user_data, void (*callbac
 		//curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
 
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, VERIFY_SSL);		
+		_c_yd_share_setopt(curl);
 		
 		if (progress_callback) {
 #if LIBCURL_VERSION_NUM < 0x073200
@@ -668,6 +1168,7 @@ int curl_upload_data(void * data, size_t size, const char * url, void *user_data
 		//curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
         
 		curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, VERIFY_SSL);		
+		_c_yd_share_setopt(curl);
 
 		if (progress_callback) {
 #if LIBCURL_VERSION_NUM < 0x073200
@@ -706,789 +1207,6554 @@ int curl_upload_data(void * data, size_t size, const char * url, void *user_data
 	return 0;
 }
 
-cJSON *c_yandex_disk_api(const char * http_method, const char *api_suffix, const char *body, const char * token, char **error, ...)
-{
-	CURL *curl;
-	struct str s;
-	char authorization[BUFSIZ];
-	sprintf(authorization, "Authorization: OAuth %s", token);
+/* pool of reusable curl handles - API calls take warm
+ * keep-alive connections (from handle or shared cache)
+ * instead of new TCP+TLS handshake */
+struct _c_yd_pool {
+	pthread_mutex_t lock;
+	pthread_cond_t  cond;
+	CURL **handles;   //idle handles
+	int    count;     //number of idle handles
+	int    size;      //max number of idle handles
+	int    busy;      //number of handles in use
+	int    limit;     //max number of handles in use (0 - no limit)
+};
 
-	curl = curl_easy_init();
-	str_init(&s);
+static int _c_yd_pool_init(
+		struct _c_yd_pool *pool, int size, int limit)
+{
+	pool->handles = MALLOC(sizeof(CURL *) * size);
+	if (!pool->handles)
+		return -1;
 	
-	if(curl) {
-		CURLcode res;
-		va_list argv;
-		char *arg;
-		char requestString[BUFSIZ];	
-		struct curl_slist *header = NULL;
-		cJSON *json;
-		
-		sprintf(requestString, "%s/%s", API_URL, api_suffix);
-		va_start(argv, error);
-		arg = va_arg(argv, char*);
-		if (arg) {
-			sprintf(requestString, "%s?%s", requestString, arg);
-			arg = va_arg(argv, char*);	
-		}
-		while (arg) {
-			sprintf(requestString, "%s&%s", requestString, arg);
-			arg = va_arg(argv, char*);	
-		}
-		va_end(argv);
+	pool->count = 0;
+	pool->size  = size;
+	pool->busy  = 0;
+	pool->limit = limit;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->cond, NULL);
+	return 0;
+}
 
-		curl_easy_setopt(curl, CURLOPT_URL, requestString);
-		curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, http_method);		
-		curl_easy_setopt(curl, CURLOPT_HEADER, 0);
-		curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);		
+/* take idle handle from pool or create new one - wait if
+ * limit of handles in use is reached */
+static CURL *_c_yd_pool_get(struct _c_yd_pool *pool)
+{
+	CURL *curl = NULL;
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->limit > 0 && pool->busy >= pool->limit)
+		pthread_cond_wait(&pool->cond, &pool->lock);
+	pool->busy++;
+	if (pool->count > 0)
+		curl = pool->handles[--pool->count];
+	pthread_mutex_unlock(&pool->lock);
+
+	if (!curl)
+		curl = curl_easy_init();
+
+	if (!curl){
+		pthread_mutex_lock(&pool->lock);
+		pool->busy--;
+		pthread_cond_signal(&pool->cond);
+		pthread_mutex_unlock(&pool->lock);
+	}
 
-		/* enable verbose for easier tracing */
-		/*curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);		*/
+	return curl;
+}
 
-	  header = curl_slist_append(header, "Connection: close");		
-	  header = curl_slist_append(header, "Content-Type: application/json");
-	  header = curl_slist_append(header, "Accept: application/json");
-	  header = curl_slist_append(header, authorization);
-		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header);
+/* return handle to pool - options are reset, but live
+ * connections, DNS and TLS session caches are kept */
+static void _c_yd_pool_put(struct _c_yd_pool *pool, CURL *curl)
+{
+	if (!curl)
+		return;
 
-		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writefunc);
-		curl_easy_setopt(curl, CURLOPT_WRITEDATA, &s);
+	curl_easy_reset(curl);
 
-		if (body) {
-			curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body);
-			curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, strlen(body));
-		}
+	pthread_mutex_lock(&pool->lock);
+	pool->busy--;
+	if (pool->count < pool->size){
+		pool->handles[pool->count++] = curl;
+		curl = NULL;
+	}
+	pthread_cond_signal(&pool->cond);
+	pthread_mutex_unlock(&pool->lock);
 
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, VERIFY_SSL);		
+	// pool is full
+	if (curl)
+		curl_easy_cleanup(curl);
+}
 
-		res = curl_easy_perform(curl);
+/* close all idle handles and free pool */
+static void _c_yd_pool_destroy(struct _c_yd_pool *pool)
+{
+	while (pool->count > 0)
+		curl_easy_cleanup(pool->handles[--pool->count]);
+	free(pool->handles);
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->cond);
+}
 
-		curl_easy_cleanup(curl);
-		curl_slist_free_all(header);
-		if (res) { //handle erros
-			if (error)
-				*error = strdup(STR("cYandexDisk: curl returned error: %d", res));
-			free(s.str);
-        return NULL;			
-		}		
-		//parse JSON answer
-		json = cJSON_ParseWithLength(s.str, s.len);
-		free(s.str);		
+/* client session */
+struct c_yd_client {
+	pthread_mutex_t      lock;
+	int                  refs;     //client is freed when 0
+	char                *token;    //access token
+	char                *fields;   //resource fields projection
+	struct curl_slist   *header;   //prebuilt API request headers
+	c_yd_client_config_t config;
+	struct _c_yd_pool    pool;     //keep-alive curl handles
+	struct _c_yd_engine *engine;   //asynchronous requests
+	struct _c_yd_workers *workers; //transfer threads
+	struct _c_yd_cache   *cache;   //metadata cache (NULL - disabled)
+	c_yd_index_t         *index;   //tree index (NULL - not used)
+};
 
-		return json;
-	}
+static void _c_yd_engine_destroy(struct _c_yd_engine *engine);
+static void _c_yd_workers_destroy(struct _c_yd_workers *workers);
+static int _c_yd_ls_pages(c_yd_client_t *client, const char *api_suffix, const char *arg, const char *fields, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error), int(*entry_callback)(const c_yd_entry_t *entry, void * user_data, const char * error));
+static int _c_yd_cache_ls(c_yd_client_t *client, const char *path, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error), int(*entry_callback)(const c_yd_entry_t *entry, void * user_data, const char * error));
+static void _c_yd_entry_to_file(const c_yd_entry_t *entry, c_yd_file_t *file);
+static bool _c_yd_in_engine(c_yd_client_t *client);
+static void _c_yd_json_arena_enable(void);
+static char *_c_yd_engine_call(c_yd_client_t *client, const char * http_method, const char *api_suffix, const char *body, size_t *len, long *code, char **error, va_list argv);
+static int _c_yd_operation(c_yd_client_t *client, const char *from, const char *to, const char *source, int index_op, const char *api_suffix, const char *arg1, const char *arg2, const char *arg3, void *user_data, int(*callback)(void *user_data, const char *error));
+
+/* metadata cache - file info and directory listings are
+ * kept by normalized path, least recently used items are
+ * evicted when cache is over size. Requests changing disk
+ * drop resource, its subtree and its parent before and
+ * after request */
+enum _c_yd_cache_kind {
+	YD_CACHE_INFO,
+	YD_CACHE_LS,
+};
 
-	free(s.str);
-	return NULL;
-}
+struct _c_yd_cache_item {
+	struct _c_yd_cache_item *prev;   //LRU list - most recent first
+	struct _c_yd_cache_item *next;
+	struct _c_yd_cache_item *chain;  //hash bucket
+	int           refs;     //cache and readers
+	int           kind;
+	unsigned long hash;
+	time_t        expires;
+	size_t        size;     //bytes of item
+	char         *path;
+	c_yd_entry_t *entries;  //entries and strings follow item
+	int           count;
+};
 
-typedef enum {
-	FILE_DOWNLOAD,
-	FILE_UPLOAD,
-	DATA_UPLOAD,
-	DATA_DOWNLOAD
-} FILE_TRANSFER;
+struct _c_yd_cache {
+	pthread_mutex_t lock;
+	struct _c_yd_cache_item *buckets[YD_CACHE_BUCKETS];
+	struct _c_yd_cache_item *head;
+	struct _c_yd_cache_item *tail;
+	int           count;
+	size_t        size;
+	size_t        max_size;
+	int           ttl;
+	unsigned long generation; //changed when items are dropped
+	unsigned long hits;
+	unsigned long misses;
+};
 
-struct curl_transfer_file_in_thread_params {
-	FILE_TRANSFER file_transfer;
-	FILE *fp;
-	char url[BUFSIZ];
-	void *user_data;
-	void (*callback)(FILE *fp, size_t size, void *user_data, const char *error);
-	void (*callback_data)(void *data, size_t size, void *user_data, const char *error);
-	void *clientp;
-	int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow);
-	void *data;
-	size_t size;
+/* string members of entry */
+static const size_t _c_yd_entry_strings[] = {
+	offsetof(c_yd_entry_t, name),
+	offsetof(c_yd_entry_t, type),
+	offsetof(c_yd_entry_t, path),
+	offsetof(c_yd_entry_t, mime_type),
+	offsetof(c_yd_entry_t, preview),
+	offsetof(c_yd_entry_t, public_key),
+	offsetof(c_yd_entry_t, public_url),
+	offsetof(c_yd_entry_t, md5),
+	offsetof(c_yd_entry_t, sha256),
 };
+#define YD_ENTRY_STRINGS \
+	(sizeof(_c_yd_entry_strings)/sizeof(*_c_yd_entry_strings))
 
-void *curl_transfer_file_in_thread(void *_params)
+/* size of strings of entry with null chars */
+static size_t _c_yd_entry_strings_size(const c_yd_entry_t *entry)
 {
-	struct curl_transfer_file_in_thread_params *params = _params;
+	size_t i, size = 0;
+	for (i = 0; i < YD_ENTRY_STRINGS; ++i)
+		size += strlen(*(const char **)((const char *)entry + _c_yd_entry_strings[i])) + 1;
+	return size;
+}
 
-	switch (params->file_transfer) {
-		case FILE_UPLOAD :
-			curl_upload_file(params->fp, params->url, params->user_data, params->callback, params->clientp, params->progress_callback);
-			break;
-		case FILE_DOWNLOAD :
-			curl_download_file(params->fp, params->url, params->user_data, params->callback, params->clientp, params->progress_callback);
-			break;			
-		case DATA_UPLOAD :
-			curl_upload_data(params->data, params->size, params->url, params->user_data, params->callback_data, params->clientp, params->progress_callback);
-			break;
-		case DATA_DOWNLOAD :
-			curl_download_data(params->url, params->user_data, params->callback_data, params->clientp, params->progress_callback);			
-			break;			
+/* copy strings of entry to p - return end of copied strings */
+static char *_c_yd_entry_strings_copy(c_yd_entry_t *entry, char *p)
+{
+	size_t i;
+	for (i = 0; i < YD_ENTRY_STRINGS; ++i) {
+		const char **str = (const char **)((char *)entry + _c_yd_entry_strings[i]);
+		size_t len = strlen(*str) + 1;
+		memcpy(p, *str, len);
+		*str = p;
+		p += len;
 	}
-
-	free(params);
-	pthread_exit(0);
-	return NULL;
+	return p;
 }
 
-int  _c_yandex_disk_transfer_file_parser(cJSON *json, FILE_TRANSFER file_transfer, bool wait_finish, FILE *fp, void * data, size_t size, char *error, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void (*callback_data)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+/* entry with strings of file */
+static void _c_yd_file_to_entry(const c_yd_file_t *file, c_yd_entry_t *entry)
 {
+	entry->name = file->name;
+	entry->type = file->type;
+	entry->path = file->path;
+	entry->mime_type = file->mime_type;
+	entry->preview = file->preview;
+	entry->public_key = file->public_key;
+	entry->public_url = file->public_url;
+	entry->md5 = file->md5;
+	entry->sha256 = file->sha256;
+	entry->size = file->size;
+	entry->created = file->created;
+	entry->modified = file->modified;
+}
 
-	int err;
-	cJSON *url;
-	struct curl_transfer_file_in_thread_params *params; 
-	pthread_t tid; //идентификатор потока
-	pthread_attr_t attr; //атрибуты потока
-
-	if (!json) {
-		if (callback)
-			callback(fp, 0,user_data,STR("cYandexDisk: %s", error));
-		return -1;
-	}
-	url = cJSON_GetObjectItem(json, "href");			
-	if (!url) {
-		cJSON *message = cJSON_GetObjectItem(json, "message");			
-		if (callback)
-			callback(fp, 0,user_data,STR("cYandexDisk: %s", message->valuestring));
-		cJSON_free(json);
-		return  -1;
+/* path without "disk:" prefix, repeated and trailing slashes */
+static void _c_yd_cache_path(const char *path, char *buf, size_t size)
+{
+	size_t len = 0;
+	
+	if (strncmp(path, "disk:", 5) == 0)
+		path += 5;
+	buf[len++] = '/';
+	for (; *path && len < size - 1; ++path) {
+		if (*path == '/' && buf[len - 1] == '/')
+			continue;
+		buf[len++] = *path;
 	}
+	if (len > 1 && buf[len - 1] == '/')
+		len--;
+	buf[len] = 0;
+}
 
-	//upload file in new thread
+static unsigned long _c_yd_cache_hash(int kind, const char *path)
+{
+	// FNV-1a
+	unsigned long hash = 2166136261UL ^ (unsigned long)kind;
+	while (*path)
+		hash = (hash ^ (unsigned char)*path++) * 16777619UL;
+	return hash;
+}
 
-	//получаем дефолтные значения атрибутов
-	err = pthread_attr_init(&attr);
-	if (err) {
-		perror("THREAD attributes");
-		if (callback)
-			callback(fp, 0,user_data,STR("cYandexDisk: %s", "THREAD attributes"));
-		return err;
-	}	
+static struct _c_yd_cache *_c_yd_cache_new(int ttl, size_t max_size)
+{
+	struct _c_yd_cache *cache = NEW(struct _c_yd_cache);
+	if (!cache)
+		return NULL;
+	cache->ttl = ttl;
+	cache->max_size = max_size;
+	pthread_mutex_init(&cache->lock, NULL);
+	return cache;
+}
 
-	//set params
-	params = NEW(struct curl_transfer_file_in_thread_params);
-	if (!params)
-		return -1;
-	params->fp = fp;
-	strcpy(params->url, url->valuestring);
-	params->user_data = user_data;
-	params->callback = callback;
-	params->file_transfer = file_transfer;
-	params->clientp = clientp;
-	params->progress_callback = progress_callback;
-	params->data = data;
-	params->size = size;
-	params->callback_data = callback_data;
-	//создаем новый поток
-	err = pthread_create(&tid,&attr, curl_transfer_file_in_thread, params);
-	if (err) {
-		perror("create THREAD");
-		if (callback)
-			callback(fp, 0,user_data,STR("cYandexDisk: %s", "create THREAD"));
-		return err;
-	}
+/* item with copy of entries - one allocation */
+static struct _c_yd_cache_item *_c_yd_cache_item_new(
+		int kind, const char *path, const c_yd_entry_t *entries, int count)
+{
+	struct _c_yd_cache_item *item;
+	size_t size = sizeof(struct _c_yd_cache_item) + 
+		count * sizeof(c_yd_entry_t) + strlen(path) + 1;
+	char *p;
+	int i;
 
-	if (wait_finish){
-		//connect to thread and wait finish
-		err = pthread_join(tid, NULL);
-		if (err) {
-			if (callback)
-				callback(fp, 0,user_data,STR("Error in THREAD: %d\n", err));
-		}	
+	for (i = 0; i < count; ++i)
+		size += _c_yd_entry_strings_size(&entries[i]);
+	item = malloc(size);
+	if (!item)
+		return NULL;
+	memset(item, 0, sizeof(struct _c_yd_cache_item));
+	item->refs = 1;
+	item->kind = kind;
+	item->hash = _c_yd_cache_hash(kind, path);
+	item->size = size;
+	item->count = count;
+	item->entries = (c_yd_entry_t *)(item + 1);
+	p = (char *)(item->entries + count);
+	for (i = 0; i < count; ++i) {
+		item->entries[i] = entries[i];
+		p = _c_yd_entry_strings_copy(&item->entries[i], p);
 	}
+	item->path = p;
+	strcpy(item->path, path);
+	return item;
+}
 
-	return 0;
+/* remove item from cache - lock is held */
+static void _c_yd_cache_unlink(
+		struct _c_yd_cache *cache, struct _c_yd_cache_item *item)
+{
+	struct _c_yd_cache_item **p = 
+		&cache->buckets[item->hash % YD_CACHE_BUCKETS];
+	
+	while (*p != item)
+		p = &(*p)->chain;
+	*p = item->chain;
+	if (item->prev)
+		item->prev->next = item->next;
+	else
+		cache->head = item->next;
+	if (item->next)
+		item->next->prev = item->prev;
+	else
+		cache->tail = item->prev;
+	
+	cache->count--;
+	cache->size -= item->size;
+	if (--item->refs == 0)
+		free(item);
 }
 
-char *
-c_yandex_disk_file_url(const char * token, const char * path, char **error)
+static void _c_yd_cache_release(
+		struct _c_yd_cache *cache, struct _c_yd_cache_item *item)
 {
-	char path_arg[BUFSIZ];
-	cJSON *href, *json;
-	size_t size;
-	char *url;
+	pthread_mutex_lock(&cache->lock);
+	if (--item->refs == 0)
+		free(item);
+	pthread_mutex_unlock(&cache->lock);
+}
 
-	sprintf(path_arg, "path=%s", path);
+static void _c_yd_cache_free(struct _c_yd_cache *cache)
+{
+	while (cache->head)
+		_c_yd_cache_unlink(cache, cache->head);
+	pthread_mutex_destroy(&cache->lock);
+	free(cache);
+}
 
-	json = c_yandex_disk_api("GET", "v1/disk/resources/download", NULL, token, error, path_arg, NULL);
-	if (!json) //no json returned
-		return NULL;
+/* return referenced item or NULL - generation is set to 
+ * put answer of request to cache */
+static struct _c_yd_cache_item *_c_yd_cache_get(
+		c_yd_client_t *client, int kind, const char *path, 
+		unsigned long *generation)
+{
+	struct _c_yd_cache *cache = client->cache;
+	struct _c_yd_cache_item *item;
+	char key[BUFSIZ];
+	unsigned long hash;
 
-	href = cJSON_GetObjectItem(json, "href");
-	if (!href){ //error to get info
-		cJSON *message = cJSON_GetObjectItem(json, "message");			
-		if (error)
-			*error = strdup(STR("cYandexDisk: %s", message->valuestring));
-		cJSON_free(json);
-		return  NULL;		
-	}	
-	size = strlen(href->valuestring);
-	url = MALLOC(BUFSIZ);
-	if (!url)
+	if (!cache)
 		return NULL;
-	strncpy(url, href->valuestring, size);
-	url[size] = '\0';
-	cJSON_free(json);
-	return url;
+	_c_yd_cache_path(path, key, sizeof(key));
+	hash = _c_yd_cache_hash(kind, key);
+	
+	pthread_mutex_lock(&cache->lock);
+	for (item = cache->buckets[hash % YD_CACHE_BUCKETS]; item; item = item->chain)
+		if (item->hash == hash && item->kind == kind && 
+				strcmp(item->path, key) == 0)
+			break;
+	if (item && item->expires <= time(NULL)){
+		_c_yd_cache_unlink(cache, item);
+		item = NULL;
+	}
+	if (item){
+		// move to head of LRU list
+		if (item->prev){
+			item->prev->next = item->next;
+			if (item->next)
+				item->next->prev = item->prev;
+			else
+				cache->tail = item->prev;
+			item->prev = NULL;
+			item->next = cache->head;
+			cache->head->prev = item;
+			cache->head = item;
+		}
+		item->refs++;
+		cache->hits++;
+	} else
+		cache->misses++;
+	*generation = cache->generation;
+	pthread_mutex_unlock(&cache->lock);
+	return item;
 }
 
-int c_yandex_disk_upload_file(const char * token, FILE *fp, const char * path, bool overwrite, bool wait_finish, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+/* put answer to cache - it is not kept if items were dropped
+ * after generation was taken */
+static void _c_yd_cache_put(
+		c_yd_client_t *client, int kind, const char *path, 
+		const c_yd_entry_t *entries, int count, unsigned long generation)
 {
-	char path_arg[BUFSIZ];
-	char overwrite_arg[32];
-	char *error;
-	cJSON *json;
+	struct _c_yd_cache *cache = client->cache;
+	struct _c_yd_cache_item *item, *old;
+	char key[BUFSIZ];
+
+	if (!cache)
+		return;
+	_c_yd_cache_path(path, key, sizeof(key));
+	item = _c_yd_cache_item_new(kind, key, entries, count);
+	if (!item)
+		return;
+	if (item->size > cache->max_size){
+		free(item);
+		return;
+	}
+	
+	pthread_mutex_lock(&cache->lock);
+	if (generation != cache->generation){
+		pthread_mutex_unlock(&cache->lock);
+		free(item);
+		return;
+	}
+	for (old = cache->buckets[item->hash % YD_CACHE_BUCKETS]; old; old = old->chain)
+		if (old->hash == item->hash && old->kind == kind && 
+				strcmp(old->path, key) == 0)
+		{
+			_c_yd_cache_unlink(cache, old);
+			break;
+		}
+	while (cache->tail && cache->size + item->size > cache->max_size)
+		_c_yd_cache_unlink(cache, cache->tail);
+	
+	item->expires = time(NULL) + cache->ttl;
+	item->chain = cache->buckets[item->hash % YD_CACHE_BUCKETS];
+	cache->buckets[item->hash % YD_CACHE_BUCKETS] = item;
+	item->next = cache->head;
+	if (cache->head)
+		cache->head->prev = item;
+	else
+		cache->tail = item;
+	cache->head = item;
+	cache->count++;
+	cache->size += item->size;
+	pthread_mutex_unlock(&cache->lock);
+}
 
+/* drop resource changed by request, its subtree and parent
+ * directory (NULL path - nothing) */
+static void _c_yd_cache_drop(c_yd_client_t *client, const char *path)
+{
+	struct _c_yd_cache *cache = client->cache;
+	struct _c_yd_cache_item *item, *next;
+	char key[BUFSIZ];
+	size_t len, parent;
 
-	sprintf(path_arg, "path=%s", path);
-	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	if (!cache || !path)
+		return;
+	_c_yd_cache_path(path, key, sizeof(key));
+	len = strlen(key);
+	parent = strrchr(key, '/') - key;
+	
+	pthread_mutex_lock(&cache->lock);
+	for (item = cache->head; item; item = next) {
+		next = item->next;
+		if (len == 1 ||
+				(strncmp(item->path, key, len) == 0 && 
+				 (item->path[len] == 0 || item->path[len] == '/')) ||
+				(strncmp(item->path, key, parent ? parent : 1) == 0 && 
+				 item->path[parent ? parent : 1] == 0))
+			_c_yd_cache_unlink(cache, item);
+	}
+	cache->generation++;
+	pthread_mutex_unlock(&cache->lock);
+}
 
-	json = c_yandex_disk_api("GET", "v1/disk/resources/upload", NULL, token, &error, path_arg, overwrite_arg, NULL);
+void c_yd_client_cache_stats(c_yd_client_t *client, c_yd_cache_stats_t *stats)
+{
+	struct _c_yd_cache *cache = client->cache;
 
-	return _c_yandex_disk_transfer_file_parser(json, FILE_UPLOAD, wait_finish, fp, NULL, 0, error, user_data, callback, NULL, clientp, progress_callback);
+	memset(stats, 0, sizeof(c_yd_cache_stats_t));
+	if (!cache)
+		return;
+	pthread_mutex_lock(&cache->lock);
+	stats->hits = cache->hits;
+	stats->misses = cache->misses;
+	stats->count = cache->count;
+	stats->size = cache->size;
+	pthread_mutex_unlock(&cache->lock);
 }
 
-int c_yandex_disk_upload_data(const char * token, void * data, size_t size, const char * path, bool overwrite, bool wait_finish, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+void c_yd_client_cache_clear(c_yd_client_t *client)
 {
-	char path_arg[BUFSIZ];
-	char overwrite_arg[32];
-	char *error = NULL;
-	cJSON *json;
-	
-	sprintf(path_arg, "path=%s", path);
-	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	_c_yd_cache_drop(client, "/");
+}
 
-	json = c_yandex_disk_api("GET", "v1/disk/resources/upload", NULL, token, &error, path_arg, overwrite_arg, NULL);
+/* persistent index of disk tree - resources are written by
+ * normalized path, index is shared by clients and guarded
+ * by lock */
+struct c_yd_index {
+	pthread_mutex_t lock;
+	treeindex_t    *ti;
+};
 
-	return _c_yandex_disk_transfer_file_parser(json, DATA_UPLOAD, wait_finish, NULL, data, size, error, user_data, NULL, callback, clientp, progress_callback);
+c_yd_index_t *c_yd_index_open(const char *filepath, char **error)
+{
+	c_yd_index_t *index = NEW(c_yd_index_t);
+	if (!index){
+		if (error)
+			*error = strdup("cYandexDisk: can't allocate memory");
+		return NULL;
+	}
+	index->ti = treeindex_open(filepath);
+	if (!index->ti){
+		if (error)
+			*error = strdup(STR("cYandexDisk: can't open index %s: %s", 
+						filepath, strerror(errno)));
+		free(index);
+		return NULL;
+	}
+	pthread_mutex_init(&index->lock, NULL);
+	return index;
 }
 
-int c_yandex_disk_download_file(const char * token, FILE *fp, const char * path, bool wait_finish, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+void c_yd_index_close(c_yd_index_t *index)
 {
-	char path_arg[BUFSIZ];
-	char *error = NULL;
-	cJSON *json;
-	
-	sprintf(path_arg, "path=%s", path);
+	if (!index)
+		return;
+	treeindex_close(index->ti);
+	pthread_mutex_destroy(&index->lock);
+	free(index);
+}
 
-	json = c_yandex_disk_api("GET", "v1/disk/resources/download", NULL, token, &error, path_arg, NULL);
-	return _c_yandex_disk_transfer_file_parser(json, FILE_DOWNLOAD, wait_finish, fp, NULL, 0, error, user_data, callback, NULL, clientp, progress_callback);
+int c_yd_index_sync(c_yd_index_t *index)
+{
+	int ret;
+	pthread_mutex_lock(&index->lock);
+	ret = treeindex_sync(index->ti);
+	pthread_mutex_unlock(&index->lock);
+	return ret;
 }
 
-int c_yandex_disk_download_data(const char * token, const char * path, bool wait_finish, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+void c_yd_client_set_index(c_yd_client_t *client, c_yd_index_t *index)
 {
-	char path_arg[BUFSIZ];
-	char *error = NULL;
-	cJSON *json;
+	client->index = index;
+}
+
+/* entry of index item - strings are in arena */
+static int _c_yd_index_entry(
+		const treeindex_item_t *item, c_yd_entry_t *entry, struct arena *arena)
+{
+	const char *name = strrchr(item->path, '/') + 1;
+	char *path = arena_alloc(arena, strlen(item->path) + 6);
 	
-	sprintf(path_arg, "path=%s", path);
+	if (!path)
+		return -1;
+	sprintf(path, "disk:%s", item->path);
+	memset(entry, 0, sizeof(c_yd_entry_t));
+	entry->name = arena_strdup(arena, name);
+	entry->type = item->dir ? "dir" : "file";
+	entry->path = path;
+	entry->mime_type = entry->preview = "";
+	entry->public_key = entry->public_url = "";
+	entry->md5 = arena_strdup(arena, item->md5);
+	entry->sha256 = arena_strdup(arena, item->sha256);
+	entry->size = item->size;
+	entry->modified = item->modified;
+	return entry->name && entry->md5 && entry->sha256 ? 0 : -1;
+}
 
-	json = c_yandex_disk_api("GET", "v1/disk/resources/download", NULL, token, &error, path_arg, NULL);
-	return _c_yandex_disk_transfer_file_parser(json, DATA_DOWNLOAD, wait_finish, NULL, NULL, 0, error, user_data, NULL, callback, clientp, progress_callback);
+c_yd_entry_t *c_yd_index_get(c_yd_index_t *index, const char *path)
+{
+	treeindex_item_t item;
+	c_yd_entry_t entry, *ret = NULL;
+	struct arena arena;
+	char key[BUFSIZ];
+
+	_c_yd_cache_path(path, key, sizeof(key));
+	arena_init(&arena, 0);
+	pthread_mutex_lock(&index->lock);
+	if (treeindex_get(index->ti, key, &item) == 0 &&
+			_c_yd_index_entry(&item, &entry, &arena) == 0)
+		ret = c_yd_entry_dup(&entry);
+	pthread_mutex_unlock(&index->lock);
+	arena_free(&arena);
+	return ret;
 }
 
-int c_yandex_disk_download_public_resource(
-		const char * token, 
-		FILE *fp, 
-		const char * public_key, 
-		bool wait_finish, 
-		void *user_data, 
-		void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
-		void *clientp, 
-		int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+/* items of directory copied from index */
+struct _c_yd_index_ls {
+	struct arena  arena;
+	c_yd_entry_t *entries;
+	int           count;
+	int           size;
+	bool          failed;
+};
+
+static int _c_yd_index_ls_item(const treeindex_item_t *item, void *user_data)
 {
-	char public_key_arg[BUFSIZ];
-	char *error = NULL;
-	cJSON *json;
+	struct _c_yd_index_ls *ls = user_data;
+
+	if (ls->count == ls->size){
+		int size = ls->size ? ls->size * 2 : 64;
+		c_yd_entry_t *entries = 
+			realloc(ls->entries, size * sizeof(c_yd_entry_t));
+		if (!entries){
+			ls->failed = true;
+			return -1;
+		}
+		ls->entries = entries;
+		ls->size = size;
+	}
+	if (_c_yd_index_entry(item, &ls->entries[ls->count++], &ls->arena)){
+		ls->failed = true;
+		return -1;
+	}
+	return 0;
+}
+
+int c_yd_index_ls(c_yd_index_t *index, const char *path, void *user_data, int(*callback)(const c_yd_entry_t *entry, void *user_data, const char *error))
+{
+	struct _c_yd_index_ls ls;
+	char key[BUFSIZ];
+	int i, count;
+
+	_c_yd_cache_path(path, key, sizeof(key));
+	memset(&ls, 0, sizeof(ls));
+	arena_init(&ls.arena, 0);
+	
+	// callback is called without lock - it may use index
+	pthread_mutex_lock(&index->lock);
+	count = treeindex_children(index->ti, key, &ls, _c_yd_index_ls_item);
+	pthread_mutex_unlock(&index->lock);
 	
-	sprintf(public_key_arg, "public_key=%s", public_key);	
+	if (ls.failed){
+		if (callback)
+			callback(NULL, user_data, "cYandexDisk: can't allocate memory");
+		count = -1;
+	}
+	for (i = 0; i < ls.count && count >= 0; ++i)
+		if (callback && callback(&ls.entries[i], user_data, NULL))
+			break;
+	
+	free(ls.entries);
+	arena_free(&ls.arena);
+	return count;
+}
 
-	json = c_yandex_disk_api("GET", "v1/disk/public/resources/download", NULL, token, &error, public_key_arg, NULL);
-	return _c_yandex_disk_transfer_file_parser(json, FILE_DOWNLOAD, wait_finish, fp, NULL, 0, error, user_data, callback, NULL, clientp, progress_callback);
+int c_yd_index_count(c_yd_index_t *index)
+{
+	int count;
+	pthread_mutex_lock(&index->lock);
+	count = treeindex_count(index->ti);
+	pthread_mutex_unlock(&index->lock);
+	return count;
 }
 
-int c_yandex_disk_download_public_resource_data(const char * token, const char * public_key, bool wait_finish, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+c_yd_int64_t c_yd_index_revision(c_yd_index_t *index)
 {
-	char public_key_arg[BUFSIZ];
-	char *error = NULL;
-	cJSON *json;
+	c_yd_int64_t revision;
+	pthread_mutex_lock(&index->lock);
+	revision = treeindex_revision(index->ti);
+	pthread_mutex_unlock(&index->lock);
+	return revision;
+}
+
+void c_yd_index_set_revision(c_yd_index_t *index, c_yd_int64_t revision)
+{
+	pthread_mutex_lock(&index->lock);
+	treeindex_set_revision(index->ti, revision);
+	pthread_mutex_unlock(&index->lock);
+}
+
+/* write resources to index - listed items of directory path 
+ * replace its items (path NULL - resources are added) */
+static void _c_yd_index_put(
+		c_yd_client_t *client, const char *path, 
+		const c_yd_entry_t *entries, int count)
+{
+	c_yd_index_t *index = client->index;
+	treeindex_item_t *items;
+	struct arena arena;
+	char key[BUFSIZ];
+	int i;
+
+	if (!index)
+		return;
+	items = malloc((count ? count : 1) * sizeof(treeindex_item_t));
+	if (!items)
+		return;
+	arena_init(&arena, 0);
+	for (i = 0; i < count; ++i) {
+		size_t size = strlen(entries[i].path) + 2;
+		char *p = arena_alloc(&arena, size);
+		if (!p || !entries[i].path[0])
+			break;
+		_c_yd_cache_path(entries[i].path, p, size);
+		items[i].path = p;
+		items[i].dir = strcmp(entries[i].type, "dir") == 0;
+		items[i].listed = 0;
+		items[i].size = entries[i].size;
+		items[i].modified = entries[i].modified;
+		items[i].md5 = entries[i].md5;
+		items[i].sha256 = entries[i].sha256;
+	}
 	
-	sprintf(public_key_arg, "public_key=%s", public_key);	
+	if (path)
+		_c_yd_cache_path(path, key, sizeof(key));
+	pthread_mutex_lock(&index->lock);
+	if (i < count){
+		// not all items - listing is not written
+		if (path)
+			treeindex_remove(index->ti, key);
+	} else if (path && !(count == 1 && strcmp(items[0].path, key) == 0))
+		treeindex_set_children(index->ti, key, items, count);
+	else
+		// listing of file is file itself
+		for (i = 0; i < count; ++i)
+			treeindex_put(index->ti, &items[i]);
+	pthread_mutex_unlock(&index->lock);
+	
+	arena_free(&arena);
+	free(items);
+}
 
-	json = c_yandex_disk_api("GET", "v1/disk/public/resources/download", NULL, token, &error, public_key_arg, NULL);
-	return _c_yandex_disk_transfer_file_parser(json, DATA_DOWNLOAD, wait_finish, NULL, NULL, 0, error, user_data, NULL, callback, clientp, progress_callback);
+/* remove resource which result of request is not known */
+static void _c_yd_index_forget(c_yd_client_t *client, const char *path)
+{
+	char key[BUFSIZ];
+
+	if (!client->index || !path)
+		return;
+	_c_yd_cache_path(path, key, sizeof(key));
+	pthread_mutex_lock(&client->index->lock);
+	treeindex_remove(client->index->ti, key);
+	pthread_mutex_unlock(&client->index->lock);
 }
-int c_json_to_c_yd_file_t(cJSON *json, c_yd_file_t *file)
+
+/* directory created by client - new directory is empty */
+static void _c_yd_index_mkdir(c_yd_client_t *client, const char *path)
 {
-	cJSON *name, *type, *path, *mime_type, *preview, *public_key,
-				*size, *public_url, *modified, *created;
+	treeindex_item_t item;
+	char key[BUFSIZ];
 
-	file->name[0] = '\0';
-	name = cJSON_GetObjectItem(json, "name");	
-	if (name) strncpy(file->name, name->valuestring, sizeof(file->name));
+	if (!client->index)
+		return;
+	_c_yd_cache_path(path, key, sizeof(key));
+	memset(&item, 0, sizeof(item));
+	item.path = key;
+	item.dir = item.listed = 1;
+	item.modified = time(NULL);
+	item.md5 = item.sha256 = "";
+	pthread_mutex_lock(&client->index->lock);
+	treeindex_put(client->index->ti, &item);
+	pthread_mutex_unlock(&client->index->lock);
+}
 
-	file->type[0] = '\0';
-	type = cJSON_GetObjectItem(json, "type");	
-	if (type) strncpy(file->type, type->valuestring, sizeof(file->type));	
+/* resource copied or moved by client */
+static void _c_yd_index_move(
+		c_yd_client_t *client, const char *from, const char *to, bool copy)
+{
+	char key_from[BUFSIZ], key_to[BUFSIZ];
 
-	file->path[0] = '\0';
-	path = cJSON_GetObjectItem(json, "path");	
-	if (path) strncpy(file->path, path->valuestring, sizeof(file->path));	
+	if (!client->index)
+		return;
+	_c_yd_cache_path(from, key_from, sizeof(key_from));
+	_c_yd_cache_path(to, key_to, sizeof(key_to));
+	pthread_mutex_lock(&client->index->lock);
+	// source is not known - destination is removed
+	treeindex_move(client->index->ti, key_from, key_to, copy);
+	pthread_mutex_unlock(&client->index->lock);
+}
 
-	file->mime_type[0] = '\0';
-	mime_type = cJSON_GetObjectItem(json, "mime_type");	
-	if (mime_type) strncpy(file->mime_type, mime_type->valuestring, sizeof(file->mime_type));	
+/* change of index when request is finished */
+enum _c_yd_index_op {
+	YD_INDEX_NONE,    //tree is not changed
+	YD_INDEX_FORGET,  //resources are removed from index
+	YD_INDEX_MKDIR,
+	YD_INDEX_COPY,
+	YD_INDEX_MOVE,
+};
 
-	file->size = 0;
-	size = cJSON_GetObjectItem(json, "size");	
-	if (size) file->size = size->valueint;	
+void c_yd_client_config_init(c_yd_client_config_t *config)
+{
+	if (!config)
+		return;
+	memset(config, 0, sizeof(c_yd_client_config_t));
+	config->max_connections = YD_POOL_SIZE;
+	config->transfer_workers = YD_TRANSFER_WORKERS;
+	config->ls_prefetch = YD_LS_PREFETCH;
+	config->cache_size = YD_CACHE_SIZE;
+}
 
-	file->preview[0] = '\0';
-	preview = cJSON_GetObjectItem(json, "preview");	
-	if (preview) strncpy(file->preview, preview->valuestring, sizeof(file->preview));	
+c_yd_client_t *c_yd_client_new(
+		const char *access_token, const c_yd_client_config_t *config)
+{
+	c_yd_client_t *client;
+	struct curl_slist *header = NULL;
+	char authorization[BUFSIZ];
 
-	file->public_key[0] = '\0';
-	public_key = cJSON_GetObjectItem(json, "public_key");	
-	if (public_key) strncpy(file->public_key, public_key->valuestring, sizeof(file->public_key));	
-	
-	file->public_url[0] = '\0';
-	public_url = cJSON_GetObjectItem(json, "public_url");	
-	if (public_url) strncpy(file->public_url, public_url->valuestring, sizeof(file->public_url));	
+	if (!access_token)
+		return NULL;
 
-	file->modified = 0;
-	modified = cJSON_GetObjectItem(json, "modified");	
-	if (modified) {
-		struct tm tm = {0};
-		sscanf(modified->valuestring, "%d-%d-%dT%d:%d:%d+00:00", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
-		tm.tm_year -= 1900; //struct tm year starts from 1900
-		tm.tm_mon -= 1; //struct tm mount start with 0 for January
-		tm.tm_isdst = 0; //should not use summer time flag		
-		//strptime(modified->valuestring, "%FT%T%z", &tm);
-		file->modified = mktime(&tm);
-	}	
+	client = NEW(c_yd_client_t);
+	if (!client)
+		return NULL;
 
-	file->created = 0;
-	created = cJSON_GetObjectItem(json, "created");	
-	if (created) {
-		struct tm tm = {0};
-		sscanf(modified->valuestring, "%d-%d-%dT%d:%d:%d+00:00", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
-		tm.tm_year -= 1900; //struct tm year starts from 1900
-		tm.tm_mon -= 1; //struct tm mount start with 0 for January
-		tm.tm_isdst = 0; //should not use summer time flag
-		/*strptime(modified->valuestring, "%FT%T%z", &tm);*/
-		file->created = mktime(&tm);
-	}		
+	if (config)
+		client->config = *config;
+	else
+		c_yd_client_config_init(&client->config);
+	if (client->config.max_connections < 1)
+		client->config.max_connections = YD_POOL_SIZE;
+	if (client->config.transfer_workers < 1)
+		client->config.transfer_workers = YD_TRANSFER_WORKERS;
+	if (client->config.ls_page_size < 1)
+		client->config.ls_page_size = YD_ANSWER_LIMIT;
+	if (client->config.ls_prefetch < 1)
+		client->config.ls_prefetch = YD_LS_PREFETCH;
+	if (client->config.cache_size < 1)
+		client->config.cache_size = YD_CACHE_SIZE;
+	if (client->config.http2){
+#if LIBCURL_VERSION_NUM >= 0x072100
+		// fallback to HTTP/1.1 if curl is built without HTTP/2
+		curl_version_info_data *info = curl_version_info(CURLVERSION_NOW);
+		if (!(info->features & CURL_VERSION_HTTP2))
+			client->config.http2 = false;
+#else
+		client->config.http2 = false;
+#endif
+	}
+
+	client->token = strdup(access_token);
+	client->fields = strdup(
+			client->config.fields ? client->config.fields : YD_FILE_FIELDS);
+	if (!client->token || !client->fields){
+		free(client->token);
+		free(client->fields);
+		free(client);
+		return NULL;
+	}
+	client->config.fields = client->fields;
+
+	// build headers once for all requests
+	snprintf(authorization, sizeof(authorization),
+			"Authorization: OAuth %s", access_token);
+	header = curl_slist_append(header, "Content-Type: application/json");
+	if (header)
+		header = curl_slist_append(header, "Accept: application/json");
+	if (header)
+		header = curl_slist_append(header, authorization);
+	if (!header){
+		free(client->token);
+		free(client->fields);
+		free(client);
+		return NULL;
+	}
+	client->header = header;
+
+	if (_c_yd_pool_init(
+				&client->pool, 
+				client->config.max_connections, 
+				client->config.concurrency))
+	{
+		curl_slist_free_all(client->header);
+		free(client->token);
+		free(client->fields);
+		free(client);
+		return NULL;
+	}
+
+	if (client->config.cache_ttl > 0)
+		client->cache = _c_yd_cache_new(
+				client->config.cache_ttl, client->config.cache_size);
+	if (client->config.json_arena)
+		_c_yd_json_arena_enable();
+
+	pthread_mutex_init(&client->lock, NULL);
+	client->refs = 1;
+	return client;
+}
+
+static c_yd_client_t *_c_yd_client_ref(c_yd_client_t *client)
+{
+	pthread_mutex_lock(&client->lock);
+	client->refs++;
+	pthread_mutex_unlock(&client->lock);
+	return client;
+}
+
+static void _c_yd_client_unref(c_yd_client_t *client)
+{
+	int refs;
 	
-	return 0;
+	pthread_mutex_lock(&client->lock);
+	refs = --client->refs;
+	pthread_mutex_unlock(&client->lock);
+	if (refs > 0)
+		return;
+
+	if (client->workers)
+		_c_yd_workers_destroy(client->workers);
+	if (client->engine)
+		_c_yd_engine_destroy(client->engine);
+	if (client->cache)
+		_c_yd_cache_free(client->cache);
+	_c_yd_pool_destroy(&client->pool);
+	curl_slist_free_all(client->header);
+	free(client->token);
+	free(client->fields);
+	pthread_mutex_destroy(&client->lock);
+	free(client);
 }
 
-int _c_yandex_disk_ls_parser(cJSON *json, char *error, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+void c_yd_client_free(c_yd_client_t *client)
 {
-	cJSON *items = NULL,
-				*_embedded;
+	if (client)
+		_c_yd_client_unref(client);
+}
 
-	if (!json) { //no json returned
-		if (callback)
-			callback(NULL,user_data,STR("cYandexDisk: %s", error));
-		return -1;
+/* clients for functions with access_token argument - 
+ * most recently used first */
+static pthread_mutex_t _c_yd_clients_lock = PTHREAD_MUTEX_INITIALIZER;
+static c_yd_client_t *_c_yd_clients[YD_CLIENTS_CACHE];
+
+/* return referenced client for access token */
+static c_yd_client_t *_c_yd_client_for_token(const char *token)
+{
+	int i;
+	c_yd_client_t *client = NULL;
+
+	if (!token)
+		return NULL;
+
+	pthread_mutex_lock(&_c_yd_clients_lock);
+	for (i = 0; i < YD_CLIENTS_CACHE && _c_yd_clients[i]; ++i) {
+		if (strcmp(_c_yd_clients[i]->token, token) == 0){
+			client = _c_yd_clients[i];
+			break;
+		}
 	}
-	if (!cJSON_GetObjectItem(json, "path")){ //error to get info of file/directory
-		cJSON *message = cJSON_GetObjectItem(json, "message");			
-		if (callback)
-			callback(NULL,user_data,STR("cYandexDisk: %s", message->valuestring));
-		cJSON_free(json);
-		return  -1;
-	}	
-	items = NULL;
-	_embedded = cJSON_GetObjectItem(json, "_embedded");
-	if (_embedded)
-		items = cJSON_GetObjectItem(_embedded, "items");
-	else 
-		items = cJSON_GetObjectItem(json, "items");
-	if (items) { //we have items in directory
-		int i, count = cJSON_GetArraySize(items);
-		if (!count)
-			return 1;
-		
-		for (i = 0; i < count; ++i) {
-			cJSON *item = cJSON_GetArrayItem(items, i);
-			c_yd_file_t file;
-			c_json_to_c_yd_file_t(item, &file);
-			if (callback)
-				callback(&file, user_data, NULL);				
+	if (!client){
+		client = c_yd_client_new(token, NULL);
+		if (client && i == YD_CLIENTS_CACHE){
+			// drop least recently used client
+			i = YD_CLIENTS_CACHE - 1;
+			_c_yd_client_unref(_c_yd_clients[i]);
 		}
-	} else { //no items - return file info
-		c_yd_file_t file;
-		c_json_to_c_yd_file_t(json, &file);
-		if (callback)
-			callback(&file, user_data, NULL);
-	}	
+	}
+	if (client){
+		// move to front
+		for (; i > 0; --i)
+			_c_yd_clients[i] = _c_yd_clients[i-1];
+		_c_yd_clients[0] = client;
+		_c_yd_client_ref(client);
+	}
+	pthread_mutex_unlock(&_c_yd_clients_lock);
 
-	return 0;
-}	
-int
-c_yandex_disk_file_info(
-		const char * token, 
-		const char * path,
-		c_yd_file_t *file,
-		char **_error
-		)
+	return client;
+}
+
+void c_yandex_disk_cleanup(void)
 {
-	char path_arg[BUFSIZ];
-	char *error = NULL;
-	cJSON *json;
+	int i;
+	pthread_mutex_lock(&_c_yd_clients_lock);
+	for (i = 0; i < YD_CLIENTS_CACHE; ++i) {
+		if (_c_yd_clients[i]){
+			_c_yd_client_unref(_c_yd_clients[i]);
+			_c_yd_clients[i] = NULL;
+		}
+	}
+	pthread_mutex_unlock(&_c_yd_clients_lock);
+	_c_yd_share_cleanup();
+}
+
+/* set client options to curl handle */
+static void _c_yd_client_setopt(c_yd_client_t *client, CURL *curl)
+{
+	curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, VERIFY_SSL);
+	_c_yd_share_setopt(curl);
+
+#if LIBCURL_VERSION_NUM >= 0x071900
+	/* keep idle pooled connections alive */
+	curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
 	
-	sprintf(path_arg, "path=%s", path);	
+	if (client->config.connect_timeout > 0)
+		curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 
+				client->config.connect_timeout);
+	if (client->config.timeout > 0)
+		curl_easy_setopt(curl, CURLOPT_TIMEOUT, 
+				client->config.timeout);
+	if (client->config.buffer_size > 0)
+		curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, 
+				client->config.buffer_size);
+
+	/* HTTP/2 for https, HTTP/1.1 if server does not 
+	 * support it */
+#if LIBCURL_VERSION_NUM >= 0x072F00
+	if (client->config.http2)
+		curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, 
+				CURL_HTTP_VERSION_2TLS);
+#elif LIBCURL_VERSION_NUM >= 0x072100
+	if (client->config.http2)
+		curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, 
+				CURL_HTTP_VERSION_2_0);
+#endif
+}
 
-	json = 
-		c_yandex_disk_api("GET", "v1/disk/resources", NULL, token, &error, path_arg, NULL);
-	if (error && _error) {
-		*_error = error;
+/* make API url from suffix and NULL-terminated list of
+ * arguments */
+static void _c_yd_api_url(
+		char *url, size_t size, const char *api_suffix, va_list argv)
+{
+	char *arg;
+	int len;
+	char sep = '?';
+
+	len = snprintf(url, size, "%s/%s", API_URL, api_suffix);
+	arg = va_arg(argv, char*);
+	while (arg && (size_t)len < size) {
+		len += snprintf(url + len, size - len, "%c%s", sep, arg);
+		sep = '&';
+		arg = va_arg(argv, char*);	
+	}
+}
+
+/* make query argument name=value - value (path, public key) 
+ * is given as is and percent-encoded here for all requests */
+static const char *_c_yd_query_arg(
+		char *buf, size_t size, const char *name, const char *value)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	size_t len = snprintf(buf, size, "%s=", name);
+
+	for (; value && *value && len + 4 < size; ++value) {
+		unsigned char c = *value;
+		if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || 
+				(c >= '0' && c <= '9') || strchr("-._~/:", c))
+			buf[len++] = c;
+		else {
+			buf[len++] = '%';
+			buf[len++] = hex[c >> 4];
+			buf[len++] = hex[c & 15];
+		}
+	}
+	buf[len] = 0;
+	return buf;
+}
+
+/* add fields projection to request argument - for listing
+ * fields of items are asked - fields of client are used if 
+ * fields is NULL - return arg if there is no projection */
+static const char *_c_yd_fields_arg(
+		c_yd_client_t *client, const char *fields, const char *arg, 
+		bool listing, char *buf, size_t size)
+{
+	const char *p = fields ? fields : client->fields;
+	size_t len;
+
+	if (!p[0])
+		return arg;
+	
+	len = snprintf(buf, size, "%s%sfields=%s", 
+			arg ? arg : "", arg ? "&" : "", p);
+	if (listing && len < size)
+		len += snprintf(buf + len, size - len, ",_embedded.total");
+	while (listing && *p && len < size) {
+		// directory items and items of flat list
+		int n = strcspn(p, ",");
+		if (n)
+			len += snprintf(buf + len, size - len, 
+					",_embedded.items.%.*s,items.%.*s", n, p, n, p);
+		p += n;
+		if (*p)
+			p++;
+	}
+	if (len >= size)
+		return arg; //too long - ask all fields
+	return buf;
+}
+
+/* memory of parsed answers - cJSON hooks take nodes of
+ * answer from blocks of request scope and release them at
+ * once with scope; out of scope malloc/free are used.
+ * Blocks are aligned to YD_JSON_BLOCK - block of pointer is
+ * found by mask and looked up in blocks of thread. Allocation
+ * bigger than block gets own block */
+struct _c_yd_json_block {
+	struct _c_yd_json_block  *next;   //next block of scope
+	struct _c_yd_json_block  *hnext;  //next block in bucket
+	struct _c_yd_json_block **hprev;
+	size_t                    size;
+	size_t                    used;
+};
+
+struct _c_yd_json_scope {
+	struct _c_yd_json_block *head;
+};
+
+/* live blocks of thread */
+struct _c_yd_json_blocks {
+	struct _c_yd_json_block *buckets[YD_JSON_BUCKETS];
+};
+
+static pthread_once_t _c_yd_json_once = PTHREAD_ONCE_INIT;
+static pthread_once_t _c_yd_json_hooks_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  _c_yd_json_blocks; //blocks of thread
+static pthread_key_t  _c_yd_json_parsing; //scope of answer being parsed
+
+#define _C_YD_JSON_BUCKET(b) \
+	(((size_t)(b) / YD_JSON_BLOCK) % YD_JSON_BUCKETS)
+
+#define _C_YD_JSON_HEADER \
+	((sizeof(struct _c_yd_json_block) + 7) & ~(size_t)7)
+
+/* add block to scope - block for size bigger than 
+ * YD_JSON_BLOCK is full after allocation */
+static struct _c_yd_json_block *_c_yd_json_block_new(
+		struct _c_yd_json_scope *scope, size_t size)
+{
+	struct _c_yd_json_blocks *blocks = 
+		pthread_getspecific(_c_yd_json_blocks);
+	struct _c_yd_json_block *b, **bucket;
+	void *p;
+
+	if (!blocks){
+		blocks = NEW(struct _c_yd_json_blocks);
+		if (!blocks || pthread_setspecific(_c_yd_json_blocks, blocks)){
+			free(blocks);
+			return NULL;
+		}
+	}
+
+	size = size > YD_JSON_BLOCK - _C_YD_JSON_HEADER ? 
+		_C_YD_JSON_HEADER + size : YD_JSON_BLOCK;
+#ifdef _WIN32
+	p = _aligned_malloc(size, YD_JSON_BLOCK);
+#else
+	if (posix_memalign(&p, YD_JSON_BLOCK, size))
+		p = NULL;
+#endif
+	if (!p)
+		return NULL;
+	b = p;
+	b->size = size;
+	b->used = _C_YD_JSON_HEADER;
+	b->next = scope->head;
+	scope->head = b;
+
+	bucket = &blocks->buckets[_C_YD_JSON_BUCKET(b)];
+	b->hnext = *bucket;
+	b->hprev = bucket;
+	if (*bucket)
+		(*bucket)->hprev = &b->hnext;
+	*bucket = b;
+	return b;
+}
+
+static void *_c_yd_json_malloc(size_t size)
+{
+	struct _c_yd_json_scope *scope = 
+		pthread_getspecific(_c_yd_json_parsing);
+	struct _c_yd_json_block *b;
+
+	if (!scope)
+		return malloc(size);
+	size = (size + 7) & ~(size_t)7;
+	b = scope->head;
+	if (!b || b->size - b->used < size){
+		b = _c_yd_json_block_new(scope, size);
+		if (!b)
+			return NULL;
+	}
+	b->used += size;
+	return (char *)b + b->used - size;
+}
+
+static void _c_yd_json_free(void *p)
+{
+	struct _c_yd_json_blocks *blocks = 
+		pthread_getspecific(_c_yd_json_blocks);
+	struct _c_yd_json_block *b, *c;
+
+	if (p && blocks){
+		b = (struct _c_yd_json_block *)
+			((size_t)p & ~(size_t)(YD_JSON_BLOCK - 1));
+		for (c = blocks->buckets[_C_YD_JSON_BUCKET(b)]; c; c = c->hnext)
+			if (c == b)
+				return; //released with scope
+	}
+	free(p);
+}
+
+static void _c_yd_json_init(void)
+{
+	pthread_key_create(&_c_yd_json_blocks, free);
+	pthread_key_create(&_c_yd_json_parsing, NULL);
+}
+
+static void _c_yd_json_hooks_init(void)
+{
+	cJSON_Hooks hooks = {_c_yd_json_malloc, _c_yd_json_free};
+	pthread_once(&_c_yd_json_once, _c_yd_json_init);
+	cJSON_InitHooks(&hooks);
+}
+
+/* set cJSON hooks once for process - client asked json_arena */
+static void _c_yd_json_arena_enable(void)
+{
+	pthread_once(&_c_yd_json_hooks_once, _c_yd_json_hooks_init);
+}
+
+static void _c_yd_json_scope_begin(struct _c_yd_json_scope *scope)
+{
+	pthread_once(&_c_yd_json_once, _c_yd_json_init);
+	scope->head = NULL;
+}
+
+/* free all trees parsed in scope */
+static void _c_yd_json_scope_end(struct _c_yd_json_scope *scope)
+{
+	while (scope->head) {
+		struct _c_yd_json_block *b = scope->head;
+		scope->head = b->next;
+		*b->hprev = b->hnext;
+		if (b->hnext)
+			b->hnext->hprev = b->hprev;
+#ifdef _WIN32
+		_aligned_free(b);
+#else
+		free(b);
+#endif
+	}
+}
+
+/* parse answer - tree is allocated in scope if it is not NULL
+ * and client uses json_arena */
+static cJSON *_c_yd_json_parse(c_yd_client_t *client,
+		struct _c_yd_json_scope *scope, const char *s, size_t len)
+{
+	cJSON *json;
+	void *parsing;
+
+	if (!scope || !client->config.json_arena)
+		return cJSON_ParseWithLength(s, len);
+
+	parsing = pthread_getspecific(_c_yd_json_parsing);
+	pthread_setspecific(_c_yd_json_parsing, scope);
+	json = cJSON_ParseWithLength(s, len);
+	pthread_setspecific(_c_yd_json_parsing, parsing);
+	return json;
+}
+
+/* API request - HTTP response code is set to code if it is not NULL */
+static cJSON *_c_yd_client_api_v(c_yd_client_t *client, struct _c_yd_json_scope *scope, long *code, const char * http_method, const char *api_suffix, const char *body, char **error, va_list argv)
+{
+	CURL *curl;
+	struct str s;
+
+	// HTTP/2 - request is multiplexed with other requests of
+	// client by engine, answer is parsed in this thread
+	if (client->config.http2 && !_c_yd_in_engine(client)){
+		cJSON *json;
+		size_t len;
+		char *answer = _c_yd_engine_call(client, http_method, api_suffix, body, &len, code, error, argv);
+		if (!answer)
+			return NULL;
+		json = _c_yd_json_parse(client, scope, answer, len);
+		free(answer);
+		return json;
+	}
+
+	curl = _c_yd_pool_get(&client->pool);
+	if (!curl){
+		if (error)
+			*error = strdup("cYandexDisk: can't init curl");
+		return NULL;
+	}
+	
+	if (str_init(&s)){
+		_c_yd_pool_put(&client->pool, curl);
+		if (error)
+			*error = strdup("cYandexDisk: can't allocate memory");
+		return NULL;
+	}
+	
+	{
+		CURLcode res;
+		char requestString[BUFSIZ];	
+		cJSON *json;
+		
+		_c_yd_api_url(requestString, sizeof(requestString), 
+				api_suffix, argv);
+
+		curl_easy_setopt(curl, CURLOPT_URL, requestString);
+		curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, http_method);		
+		curl_easy_setopt(curl, CURLOPT_HEADER, 0);
+		curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);		
+
+		/* enable verbose for easier tracing */
+		/*curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);		*/
+
+		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, client->header);
+
+		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writefunc);
+		curl_easy_setopt(curl, CURLOPT_WRITEDATA, &s);
+
+		if (body) {
+			curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body);
+			curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, strlen(body));
+		}
+
+		_c_yd_client_setopt(client, curl);
+
+		res = curl_easy_perform(curl);
+		if (code)
+			curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, code);
+
+		_c_yd_pool_put(&client->pool, curl);
+		if (res) { //handle erros
+			if (error)
+				*error = strdup(STR("cYandexDisk: curl returned error: %d", res));
+			free(s.str);
+        return NULL;			
+		}		
+		//parse JSON answer
+		json = _c_yd_json_parse(client, scope, s.str, s.len);
+		free(s.str);		
+
+		return json;
+	}
+}
+
+cJSON *c_yd_client_api(c_yd_client_t *client, const char * http_method, const char *api_suffix, const char *body, char **error, ...)
+{
+	cJSON *json;
+	va_list argv;
+	
+	va_start(argv, error);
+	json = _c_yd_client_api_v(client, NULL, NULL, http_method, api_suffix, body, error, argv);
+	va_end(argv);
+	return json;
+}
+
+/* API request with answer allocated in scope */
+static cJSON *_c_yd_client_api_scoped(c_yd_client_t *client, struct _c_yd_json_scope *scope, const char * http_method, const char *api_suffix, const char *body, char **error, ...)
+{
+	cJSON *json;
+	va_list argv;
+	
+	va_start(argv, error);
+	json = _c_yd_client_api_v(client, scope, NULL, http_method, api_suffix, body, error, argv);
+	va_end(argv);
+	return json;
+}
+
+/* API request with answer allocated in scope and HTTP response code */
+static cJSON *_c_yd_client_api_code(c_yd_client_t *client, struct _c_yd_json_scope *scope, long *code, const char * http_method, const char *api_suffix, const char *body, char **error, ...)
+{
+	cJSON *json;
+	va_list argv;
+	
+	va_start(argv, error);
+	json = _c_yd_client_api_v(client, scope, code, http_method, api_suffix, body, error, argv);
+	va_end(argv);
+	return json;
+}
+
+cJSON *c_yandex_disk_api(const char * http_method, const char *api_suffix, const char *body, const char * token, char **error, ...)
+{
+	cJSON *json;
+	va_list argv;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	
+	if (!client){
+		if (error)
+			*error = strdup("cYandexDisk: can't create client");
+		return NULL;
+	}
+	
+	va_start(argv, error);
+	json = _c_yd_client_api_v(client, NULL, NULL, http_method, api_suffix, body, error, argv);
+	va_end(argv);
+	
+	_c_yd_client_unref(client);
+	return json;
+}
+
+typedef enum {
+	FILE_DOWNLOAD,
+	FILE_UPLOAD,
+	DATA_UPLOAD,
+	DATA_DOWNLOAD,
+	DATA_STREAM
+} FILE_TRANSFER;
+
+struct curl_transfer_file_in_thread_params {
+	FILE_TRANSFER file_transfer;
+	FILE *fp;
+	char *url;
+	void *user_data;
+	void (*callback)(FILE *fp, size_t size, void *user_data, const char *error);
+	void (*callback_data)(void *data, size_t size, void *user_data, const char *error);
+	int (*callback_stream)(c_yd_stream_t *stream, const void *data, size_t size, void *user_data, const char *error);
+	void *clientp;
+	int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow);
+	void *data;
+	size_t size;
+	int streams;
+	size_t chunk_size;
+};
+
+static void curl_transfer_file(struct curl_transfer_file_in_thread_params *params)
+{
+	switch (params->file_transfer) {
+		case FILE_UPLOAD :
+			curl_upload_file(params->fp, params->url, params->user_data, params->callback, params->clientp, params->progress_callback);
+			break;
+		case FILE_DOWNLOAD :
+			if (params->streams > 1)
+				curl_download_file_ranges(params->fp, params->url, params->streams, params->chunk_size, params->user_data, params->callback, params->clientp, params->progress_callback);
+			else
+				curl_download_file(params->fp, params->url, params->user_data, params->callback, params->clientp, params->progress_callback);
+			break;			
+		case DATA_UPLOAD :
+			curl_upload_data(params->data, params->size, params->url, params->user_data, params->callback_data, params->clientp, params->progress_callback);
+			break;
+		case DATA_DOWNLOAD :
+			curl_download_data(params->url, params->user_data, params->callback_data, params->clientp, params->progress_callback);			
+			break;			
+		case DATA_STREAM :
+			curl_download_stream(params->url, params->user_data, params->callback_stream, params->clientp, params->progress_callback);
+			break;
+	}
+}
+
+/* pass error to callback of transfer */
+static void curl_transfer_file_error(
+		struct curl_transfer_file_in_thread_params *params, const char *error)
+{
+	switch (params->file_transfer) {
+		case FILE_UPLOAD :
+		case FILE_DOWNLOAD :
+			if (params->callback)
+				params->callback(params->fp, 0, params->user_data, error);
+			break;
+		case DATA_UPLOAD :
+			if (params->callback_data)
+				params->callback_data(params->data, 0, params->user_data, error);
+			break;
+		case DATA_DOWNLOAD :
+			if (params->callback_data)
+				params->callback_data(NULL, 0, params->user_data, error);
+			break;
+		case DATA_STREAM :
+			if (params->callback_stream)
+				params->callback_stream(NULL, NULL, 0, params->user_data, error);
+			break;
+	}
+}
+
+/* transfer job or copy/move operation - job params call job
+ * callbacks which keep result and call callbacks of caller */
+struct c_yd_job {
+	pthread_mutex_t lock;
+	int             refs;      //worker and job handle
+	c_yd_job_status_t status;
+	bool            cancelled; //stop transfer or operation
+	size_t          bytes;     //transferred bytes
+	char           *error;     //first error of job
+	c_yd_client_t  *client;    //referenced while job is queued or running
+	struct curl_transfer_file_in_thread_params params;
+	char           *path;      //uploaded resource - dropped from cache
+	struct c_yd_job *next;     //queue
+	// callbacks of caller
+	void           *user_data;
+	void (*callback)(FILE *fp, size_t size, void *user_data, const char *error);
+	void (*callback_data)(void *data, size_t size, void *user_data, const char *error);
+	int (*callback_stream)(c_yd_stream_t *stream, const void *data, size_t size, void *user_data, const char *error);
+	void           *clientp;
+	int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow);
+};
+
+/* signaled when any job finished - waiting for many jobs */
+static pthread_mutex_t _c_yd_jobs_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  _c_yd_jobs_cond = PTHREAD_COND_INITIALIZER;
+
+static c_yd_job_t *_c_yd_job_new(c_yd_job_status_t status)
+{
+	c_yd_job_t *job = NEW(c_yd_job_t);
+	if (!job)
+		return NULL;
+	pthread_mutex_init(&job->lock, NULL);
+	job->refs = 1;
+	job->status = status;
+	return job;
+}
+
+static void _c_yd_job_unref(c_yd_job_t *job)
+{
+	int refs;
+
+	pthread_mutex_lock(&job->lock);
+	refs = --job->refs;
+	pthread_mutex_unlock(&job->lock);
+	if (refs > 0)
+		return;
+
+	free(job->params.url);
+	free(job->path);
+	free(job->error);
+	pthread_mutex_destroy(&job->lock);
+	free(job);
+}
+
+/* keep bytes and first error of job */
+static void _c_yd_job_result(
+		c_yd_job_t *job, size_t size, const char *error)
+{
+	pthread_mutex_lock(&job->lock);
+	if (size > job->bytes)
+		job->bytes = size;
+	if (error && !job->error)
+		job->error = strdup(error);
+	pthread_mutex_unlock(&job->lock);
+}
+
+static void _c_yd_job_callback(
+		FILE *fp, size_t size, void *user_data, const char *error)
+{
+	c_yd_job_t *job = user_data;
+	_c_yd_job_result(job, size, error);
+	if (job->callback)
+		job->callback(fp, size, job->user_data, error);
+}
+
+static void _c_yd_job_callback_data(
+		void *data, size_t size, void *user_data, const char *error)
+{
+	c_yd_job_t *job = user_data;
+	_c_yd_job_result(job, size, error);
+	if (job->callback_data)
+		job->callback_data(data, size, job->user_data, error);
+}
+
+static int _c_yd_job_callback_stream(
+		c_yd_stream_t *stream, const void *data, size_t size, 
+		void *user_data, const char *error)
+{
+	c_yd_job_t *job = user_data;
+	// last call has delivered size and no data
+	if (!data)
+		_c_yd_job_result(job, size, error);
+	if (job->callback_stream)
+		return job->callback_stream(stream, data, size, job->user_data, error);
+	return 0;
+}
+
+/* non-zero stops transfer */
+static int _c_yd_job_progress(void *clientp, 
+		double dltotal, double dlnow, double ultotal, double ulnow)
+{
+	c_yd_job_t *job = clientp;
+	bool cancelled;
+	
+	pthread_mutex_lock(&job->lock);
+	cancelled = job->cancelled;
+	pthread_mutex_unlock(&job->lock);
+	if (cancelled)
+		return 1;
+	if (job->progress_callback)
+		return job->progress_callback(job->clientp, dltotal, dlnow, ultotal, ulnow);
+	return 0;
+}
+
+static void _c_yd_job_start(c_yd_job_t *job)
+{
+	pthread_mutex_lock(&job->lock);
+	job->status = C_YD_JOB_RUNNING;
+	pthread_mutex_unlock(&job->lock);
+}
+
+static void _c_yd_job_finish(c_yd_job_t *job)
+{
+	pthread_mutex_lock(&job->lock);
+	if (!job->error)
+		job->status = C_YD_JOB_DONE;
+	else if (job->cancelled)
+		job->status = C_YD_JOB_CANCELLED;
+	else
+		job->status = C_YD_JOB_FAILED;
+	pthread_mutex_unlock(&job->lock);
+	
+	pthread_mutex_lock(&_c_yd_jobs_lock);
+	pthread_cond_broadcast(&_c_yd_jobs_cond);
+	pthread_mutex_unlock(&_c_yd_jobs_lock);
+	_c_yd_job_unref(job);
+}
+
+c_yd_job_status_t c_yd_job_status(c_yd_job_t *job)
+{
+	c_yd_job_status_t status;
+
+	pthread_mutex_lock(&job->lock);
+	status = job->status;
+	pthread_mutex_unlock(&job->lock);
+	return status;
+}
+
+static int _c_yd_jobs_finished(c_yd_job_t **jobs, int count)
+{
+	int i, finished = 0;
+	for (i = 0; i < count; ++i) {
+		if (jobs[i] && c_yd_job_status(jobs[i]) >= C_YD_JOB_DONE)
+			finished++;
+	}
+	return finished;
+}
+
+int c_yd_job_wait_many(
+		c_yd_job_t **jobs, int count, bool all, long timeout)
+{
+	struct timespec ts;
+	int i, need = 0, finished;
+
+	for (i = 0; i < count; ++i) {
+		if (jobs[i])
+			need++;
+	}
+	if (!all && need > 1)
+		need = 1;
+
+	if (timeout >= 0){
+#ifdef _WIN32
+		struct _timeb tb;
+		_ftime(&tb);
+		ts.tv_sec = (long)tb.time;
+		ts.tv_nsec = tb.millitm * 1000000L;
+#else
+		clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+		ts.tv_sec += timeout / 1000;
+		ts.tv_nsec += (timeout % 1000) * 1000000L;
+		if (ts.tv_nsec >= 1000000000L){
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000L;
+		}
+	}
+
+	// job sets status before signal under jobs lock
+	pthread_mutex_lock(&_c_yd_jobs_lock);
+	while ((finished = _c_yd_jobs_finished(jobs, count)) < need) {
+		if (timeout < 0)
+			pthread_cond_wait(&_c_yd_jobs_cond, &_c_yd_jobs_lock);
+		else if (pthread_cond_timedwait(
+					&_c_yd_jobs_cond, &_c_yd_jobs_lock, &ts) == ETIMEDOUT)
+		{
+			finished = _c_yd_jobs_finished(jobs, count);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&_c_yd_jobs_lock);
+	return finished;
+}
+
+int c_yd_job_wait_timeout(c_yd_job_t *job, long timeout)
+{
+	return c_yd_job_wait_many(&job, 1, true, timeout) == 1 ? 0 : -1;
+}
+
+void c_yd_job_wait(c_yd_job_t *job)
+{
+	c_yd_job_wait_many(&job, 1, true, -1);
+}
+
+size_t c_yd_job_bytes(c_yd_job_t *job)
+{
+	size_t bytes;
+
+	pthread_mutex_lock(&job->lock);
+	bytes = job->bytes;
+	pthread_mutex_unlock(&job->lock);
+	return bytes;
+}
+
+const char *c_yd_job_error(c_yd_job_t *job)
+{
+	const char *error;
+
+	// error is not changed when job is finished
+	pthread_mutex_lock(&job->lock);
+	error = job->status >= C_YD_JOB_DONE ? job->error : NULL;
+	pthread_mutex_unlock(&job->lock);
+	return error;
+}
+
+void c_yd_job_free(c_yd_job_t *job)
+{
+	if (job)
+		_c_yd_job_unref(job);
+}
+
+/* threads for transfers without wait_finish - number of
+ * threads and length of queue are limited by client config */
+struct _c_yd_workers {
+	pthread_mutex_t lock;
+	pthread_cond_t  cond;      //signaled when job queued or stop
+	pthread_cond_t  idle;      //signaled when job taken or finished
+	pthread_t      *threads;
+	int             count;     //number of threads
+	int             alive;     //number of not finished threads
+	c_yd_job_t     *queue;     //queued jobs
+	c_yd_job_t     *tail;
+	int             queued;    //number of queued jobs
+	int             running;   //number of jobs in progress
+	int             limit;     //max number of queued jobs (0 - no limit)
+	bool            stop;
+	bool            detached;  //destroyed from worker thread
+};
+
+static void _c_yd_workers_free(struct _c_yd_workers *workers)
+{
+	pthread_mutex_destroy(&workers->lock);
+	pthread_cond_destroy(&workers->cond);
+	pthread_cond_destroy(&workers->idle);
+	free(workers->threads);
+	free(workers);
+}
+
+static void *_c_yd_workers_thread(void *_workers)
+{
+	struct _c_yd_workers *workers = _workers;
+	c_yd_client_t *client;
+	c_yd_job_t *job;
+	bool detached;
+
+	pthread_mutex_lock(&workers->lock);
+	for (;;) {
+		while (!workers->queue && !workers->stop)
+			pthread_cond_wait(&workers->cond, &workers->lock);
+		if (!workers->queue)
+			break;
+
+		job = workers->queue;
+		workers->queue = job->next;
+		if (!workers->queue)
+			workers->tail = NULL;
+		workers->queued--;
+		workers->running++;
+		pthread_cond_broadcast(&workers->idle);
+		pthread_mutex_unlock(&workers->lock);
+
+		_c_yd_job_start(job);
+		curl_transfer_file(&job->params);
+		client = job->client;
+		_c_yd_cache_drop(client, job->path);
+		_c_yd_index_forget(client, job->path);
+		_c_yd_job_finish(job);
+
+		pthread_mutex_lock(&workers->lock);
+		workers->running--;
+		pthread_cond_broadcast(&workers->idle);
+		pthread_mutex_unlock(&workers->lock);
+		_c_yd_client_unref(client);
+		pthread_mutex_lock(&workers->lock);
+	}
+	workers->alive--;
+	detached = workers->detached && workers->alive == 0;
+	pthread_mutex_unlock(&workers->lock);
+
+	// last thread frees workers destroyed from callback
+	if (detached)
+		_c_yd_workers_free(workers);
+	return NULL;
+}
+
+static struct _c_yd_workers *_c_yd_workers_new(int count, int limit)
+{
+	int i;
+	struct _c_yd_workers *workers = NEW(struct _c_yd_workers);
+	if (!workers)
+		return NULL;
+
+	workers->threads = MALLOC(sizeof(pthread_t) * count);
+	if (!workers->threads){
+		free(workers);
+		return NULL;
+	}
+	workers->limit = limit;
+	pthread_mutex_init(&workers->lock, NULL);
+	pthread_cond_init(&workers->cond, NULL);
+	pthread_cond_init(&workers->idle, NULL);
+
+	pthread_mutex_lock(&workers->lock);
+	for (i = 0; i < count; ++i) {
+		if (pthread_create(&workers->threads[i], NULL, 
+					_c_yd_workers_thread, workers))
+		{
+			perror("create THREAD");
+			break;
+		}
+		workers->count++;
+		workers->alive++;
+	}
+	pthread_mutex_unlock(&workers->lock);
+
+	if (workers->count == 0){
+		_c_yd_workers_free(workers);
+		return NULL;
+	}
+	return workers;
+}
+
+/* cancel queued jobs, wait running jobs and stop threads */
+static void _c_yd_workers_destroy(struct _c_yd_workers *workers)
+{
+	c_yd_job_t *queue, *job;
+	bool in_worker = false;
+	int i;
+
+	pthread_mutex_lock(&workers->lock);
+	workers->stop = true;
+	queue = workers->queue;
+	workers->queue = workers->tail = NULL;
+	workers->queued = 0;
+	pthread_cond_broadcast(&workers->cond);
+	pthread_cond_broadcast(&workers->idle);
+	pthread_mutex_unlock(&workers->lock);
+
+	while ((job = queue)) {
+		c_yd_client_t *client = job->client;
+		queue = job->next;
+		// transfer functions close downloaded file
+		if (job->params.file_transfer == FILE_DOWNLOAD)
+			fclose(job->params.fp);
+		pthread_mutex_lock(&job->lock);
+		job->cancelled = true;
+		pthread_mutex_unlock(&job->lock);
+		curl_transfer_file_error(&job->params, "cYandexDisk: transfer cancelled");
+		_c_yd_job_finish(job);
+		_c_yd_client_unref(client);
+	}
+
+	for (i = 0; i < workers->count; ++i) {
+		if (pthread_equal(pthread_self(), workers->threads[i]))
+			in_worker = true;
+		else
+			pthread_join(workers->threads[i], NULL);
+	}
+
+	if (in_worker){
+		// last client reference dropped in transfer callback -
+		// this thread frees workers when job is finished
+		pthread_detach(pthread_self());
+		pthread_mutex_lock(&workers->lock);
+		workers->detached = true;
+		pthread_mutex_unlock(&workers->lock);
+		return;
+	}
+	_c_yd_workers_free(workers);
+}
+
+/* add job to queue - wait if queue is full */
+static int _c_yd_workers_submit(
+		struct _c_yd_workers *workers, c_yd_job_t *job)
+{
+	pthread_mutex_lock(&workers->lock);
+	while (workers->limit > 0 && workers->queued >= workers->limit && 
+			!workers->stop)
+		pthread_cond_wait(&workers->idle, &workers->lock);
+	if (workers->stop){
+		pthread_mutex_unlock(&workers->lock);
+		return -1;
+	}
+	job->next = NULL;
+	if (workers->tail)
+		workers->tail->next = job;
+	else
+		workers->queue = job;
+	workers->tail = job;
+	workers->queued++;
+	pthread_cond_signal(&workers->cond);
+	pthread_mutex_unlock(&workers->lock);
+	return 0;
+}
+
+static struct _c_yd_workers *_c_yd_client_workers(c_yd_client_t *client)
+{
+	struct _c_yd_workers *workers;
+	
+	pthread_mutex_lock(&client->lock);
+	if (!client->workers)
+		client->workers = _c_yd_workers_new(
+				client->config.transfer_workers, 
+				client->config.transfer_queue);
+	workers = client->workers;
+	pthread_mutex_unlock(&client->lock);
+
+	return workers;
+}
+
+void c_yd_client_transfers_drain(c_yd_client_t *client)
+{
+	struct _c_yd_workers *workers;
+	
+	pthread_mutex_lock(&client->lock);
+	workers = client->workers;
+	pthread_mutex_unlock(&client->lock);
+	if (!workers)
+		return;
+
+	pthread_mutex_lock(&workers->lock);
+	while (workers->queued > 0 || workers->running > 0)
+		pthread_cond_wait(&workers->idle, &workers->lock);
+	pthread_mutex_unlock(&workers->lock);
+}
+
+void c_yd_client_transfers_shutdown(c_yd_client_t *client)
+{
+	struct _c_yd_workers *workers;
+	
+	pthread_mutex_lock(&client->lock);
+	workers = client->workers;
+	client->workers = NULL;
+	pthread_mutex_unlock(&client->lock);
+	if (workers)
+		_c_yd_workers_destroy(workers);
+}
+
+/* remove job from queue of workers - return true if job was 
+ * queued */
+static bool _c_yd_workers_remove(
+		struct _c_yd_workers *workers, c_yd_job_t *job)
+{
+	c_yd_job_t **pp, *prev = NULL;
+	bool removed = false;
+
+	pthread_mutex_lock(&workers->lock);
+	for (pp = &workers->queue; *pp; pp = &(*pp)->next) {
+		if (*pp == job){
+			*pp = job->next;
+			if (workers->tail == job)
+				workers->tail = prev;
+			workers->queued--;
+			pthread_cond_broadcast(&workers->idle);
+			removed = true;
+			break;
+		}
+		prev = *pp;
+	}
+	pthread_mutex_unlock(&workers->lock);
+	return removed;
+}
+
+void c_yd_job_cancel(c_yd_job_t *job)
+{
+	c_yd_client_t *client = NULL;
+	bool removed = false;
+
+	if (!job)
+		return;
+
+	// queued job keeps client reference
+	pthread_mutex_lock(&job->lock);
+	job->cancelled = true;
+	if (job->status == C_YD_JOB_QUEUED && job->client)
+		client = _c_yd_client_ref(job->client);
+	pthread_mutex_unlock(&job->lock);
+	if (!client)
+		return;
+
+	// workers are not destroyed while client is locked
+	pthread_mutex_lock(&client->lock);
+	if (client->workers)
+		removed = _c_yd_workers_remove(client->workers, job);
+	pthread_mutex_unlock(&client->lock);
+
+	if (removed){
+		// transfer functions close downloaded file
+		if (job->params.file_transfer == FILE_DOWNLOAD)
+			fclose(job->params.fp);
+		curl_transfer_file_error(&job->params, "cYandexDisk: transfer cancelled");
+		_c_yd_job_finish(job);
+		_c_yd_client_unref(client);
+	}
+	_c_yd_client_unref(client);
+}
+
+int  _c_yandex_disk_transfer_file_parser(c_yd_client_t *client, const char *path, cJSON *json, FILE_TRANSFER file_transfer, bool wait_finish, c_yd_job_t **_job, FILE *fp, void * data, size_t size, char *error, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void (*callback_data)(void *data, size_t size, void *user_data, const char *error), int (*callback_stream)(c_yd_stream_t *stream, const void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	cJSON *url;
+	c_yd_job_t *job; 
+	struct _c_yd_workers *workers;
+
+	if (!json) {
+		if (callback)
+			callback(fp, 0,user_data,STR("cYandexDisk: %s", error));
+		if (callback_stream)
+			callback_stream(NULL, NULL, 0, user_data, STR("cYandexDisk: %s", error));
+		free(error);
+		return -1;
+	}
+	url = cJSON_GetObjectItem(json, "href");			
+	if (!url) {
+		cJSON *message = cJSON_GetObjectItem(json, "message");			
+		if (callback)
+			callback(fp, 0,user_data,STR("cYandexDisk: %s", message->valuestring));
+		if (callback_stream)
+			callback_stream(NULL, NULL, 0, user_data, STR("cYandexDisk: %s", message->valuestring));
+		cJSON_Delete(json);
+		return  -1;
+	}
+
+	//set params
+	job = _c_yd_job_new(wait_finish ? C_YD_JOB_RUNNING : C_YD_JOB_QUEUED);
+	if (!job){
+		cJSON_Delete(json);
+		return -1;
+	}
+	job->params.url = strdup(url->valuestring);
+	cJSON_Delete(json);
+	if (!job->params.url || (path && !(job->path = strdup(path)))){
+		_c_yd_job_unref(job);
+		return -1;
+	}
+	job->user_data = user_data;
+	job->callback = callback;
+	job->callback_data = callback_data;
+	job->callback_stream = callback_stream;
+	job->clientp = clientp;
+	job->progress_callback = progress_callback;
+	job->params.fp = fp;
+	job->params.user_data = job;
+	job->params.callback = _c_yd_job_callback;
+	job->params.file_transfer = file_transfer;
+	job->params.clientp = job;
+	job->params.progress_callback = _c_yd_job_progress;
+	job->params.data = data;
+	job->params.size = size;
+	job->params.callback_data = _c_yd_job_callback_data;
+	job->params.callback_stream = _c_yd_job_callback_stream;
+	job->params.streams = client->config.download_streams;
+	job->params.chunk_size = client->config.download_chunk_size;
+
+	if (wait_finish){
+		// transfer in this thread
+		curl_transfer_file(&job->params);
+		_c_yd_cache_drop(client, path);
+		_c_yd_index_forget(client, path);
+		_c_yd_job_finish(job);
+		return 0;
+	}
+
+	// transfer in worker thread
+	if (_job){
+		job->refs++;
+		*_job = job;
+	}
+	job->client = _c_yd_client_ref(client);
+	workers = _c_yd_client_workers(client);
+	if (!workers || _c_yd_workers_submit(workers, job)){
+		curl_transfer_file_error(&job->params, "cYandexDisk: can't start transfer");
+		_c_yd_job_finish(job);
+		_c_yd_client_unref(client);
+		return -1;
+	}
+
+	return 0;
+}
+
+char *
+c_yd_client_file_url(c_yd_client_t *client, const char * path, char **error)
+{
+	char path_arg[BUFSIZ];
+	cJSON *href, *json;
+	struct _c_yd_json_scope scope;
+	size_t size;
+	char *url = NULL;
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/resources/download", NULL, error, path_arg, NULL);
+	if (!json){ //no json returned
+		_c_yd_json_scope_end(&scope);
+		return NULL;
+	}
+
+	href = cJSON_GetObjectItem(json, "href");
+	if (!href){ //error to get info
+		cJSON *message = cJSON_GetObjectItem(json, "message");			
+		if (error)
+			*error = strdup(STR("cYandexDisk: %s", message->valuestring));
+		cJSON_Delete(json);
+		_c_yd_json_scope_end(&scope);
+		return  NULL;		
+	}	
+	size = strlen(href->valuestring);
+	url = MALLOC(BUFSIZ);
+	if (url){
+		strncpy(url, href->valuestring, size);
+		url[size] = '\0';
+	}
+	cJSON_Delete(json);
+	_c_yd_json_scope_end(&scope);
+	return url;
+}
+
+static int _c_yd_client_upload_file(c_yd_client_t *client, FILE *fp, const char * path, bool overwrite, bool wait_finish, c_yd_job_t **job, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	char *error = NULL;
+	cJSON *json;
+	struct _c_yd_json_scope scope;
+	int ret;
+
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+
+	_c_yd_cache_drop(client, path);
+	_c_yd_index_forget(client, path);
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/resources/upload", NULL, &error, path_arg, overwrite_arg, NULL);
+
+	ret = _c_yandex_disk_transfer_file_parser(client, path, json, FILE_UPLOAD, wait_finish, job, fp, NULL, 0, error, user_data, callback, NULL, NULL, clientp, progress_callback);
+	_c_yd_json_scope_end(&scope);
+	return ret;
+}
+
+int c_yd_client_upload_file(c_yd_client_t *client, FILE *fp, const char * path, bool overwrite, bool wait_finish, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	return _c_yd_client_upload_file(client, fp, path, overwrite, wait_finish, NULL, user_data, callback, clientp, progress_callback);
+}
+
+c_yd_job_t *c_yd_client_upload_file_job(c_yd_client_t *client, FILE *fp, const char * path, bool overwrite, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	c_yd_job_t *job = NULL;
+	_c_yd_client_upload_file(client, fp, path, overwrite, false, &job, user_data, callback, clientp, progress_callback);
+	return job;
+}
+
+static int _c_yd_client_upload_data(c_yd_client_t *client, void * data, size_t size, const char * path, bool overwrite, bool wait_finish, c_yd_job_t **job, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	char *error = NULL;
+	cJSON *json;
+	struct _c_yd_json_scope scope;
+	int ret;
+	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+
+	_c_yd_cache_drop(client, path);
+	_c_yd_index_forget(client, path);
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/resources/upload", NULL, &error, path_arg, overwrite_arg, NULL);
+
+	ret = _c_yandex_disk_transfer_file_parser(client, path, json, DATA_UPLOAD, wait_finish, job, NULL, data, size, error, user_data, NULL, callback, NULL, clientp, progress_callback);
+	_c_yd_json_scope_end(&scope);
+	return ret;
+}
+
+int c_yd_client_upload_data(c_yd_client_t *client, void * data, size_t size, const char * path, bool overwrite, bool wait_finish, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	return _c_yd_client_upload_data(client, data, size, path, overwrite, wait_finish, NULL, user_data, callback, clientp, progress_callback);
+}
+
+c_yd_job_t *c_yd_client_upload_data_job(c_yd_client_t *client, void * data, size_t size, const char * path, bool overwrite, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	c_yd_job_t *job = NULL;
+	_c_yd_client_upload_data(client, data, size, path, overwrite, false, &job, user_data, callback, clientp, progress_callback);
+	return job;
+}
+
+static int _c_yd_client_download_file(c_yd_client_t *client, FILE *fp, const char * path, bool wait_finish, c_yd_job_t **job, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char path_arg[BUFSIZ];
+	char *error = NULL;
+	cJSON *json;
+	struct _c_yd_json_scope scope;
+	int ret;
+	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/resources/download", NULL, &error, path_arg, NULL);
+	ret = _c_yandex_disk_transfer_file_parser(client, NULL, json, FILE_DOWNLOAD, wait_finish, job, fp, NULL, 0, error, user_data, callback, NULL, NULL, clientp, progress_callback);
+	_c_yd_json_scope_end(&scope);
+	return ret;
+}
+
+int c_yd_client_download_file(c_yd_client_t *client, FILE *fp, const char * path, bool wait_finish, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	return _c_yd_client_download_file(client, fp, path, wait_finish, NULL, user_data, callback, clientp, progress_callback);
+}
+
+c_yd_job_t *c_yd_client_download_file_job(c_yd_client_t *client, FILE *fp, const char * path, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	c_yd_job_t *job = NULL;
+	_c_yd_client_download_file(client, fp, path, false, &job, user_data, callback, clientp, progress_callback);
+	return job;
+}
+
+static int _c_yd_client_download_data(c_yd_client_t *client, const char * path, bool wait_finish, c_yd_job_t **job, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char path_arg[BUFSIZ];
+	char *error = NULL;
+	cJSON *json;
+	struct _c_yd_json_scope scope;
+	int ret;
+	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/resources/download", NULL, &error, path_arg, NULL);
+	ret = _c_yandex_disk_transfer_file_parser(client, NULL, json, DATA_DOWNLOAD, wait_finish, job, NULL, NULL, 0, error, user_data, NULL, callback, NULL, clientp, progress_callback);
+	_c_yd_json_scope_end(&scope);
+	return ret;
+}
+
+int c_yd_client_download_data(c_yd_client_t *client, const char * path, bool wait_finish, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	return _c_yd_client_download_data(client, path, wait_finish, NULL, user_data, callback, clientp, progress_callback);
+}
+
+c_yd_job_t *c_yd_client_download_data_job(c_yd_client_t *client, const char * path, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	c_yd_job_t *job = NULL;
+	_c_yd_client_download_data(client, path, false, &job, user_data, callback, clientp, progress_callback);
+	return job;
+}
+
+int c_yd_client_download_stream(c_yd_client_t *client, const char * path, bool wait_finish, void *user_data, int (*callback)(c_yd_stream_t *stream, const void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char path_arg[BUFSIZ];
+	char *error = NULL;
+	cJSON *json;
+	struct _c_yd_json_scope scope;
+	int ret;
+	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/resources/download", NULL, &error, path_arg, NULL);
+	ret = _c_yandex_disk_transfer_file_parser(client, NULL, json, DATA_STREAM, wait_finish, NULL, NULL, NULL, 0, error, user_data, NULL, NULL, callback, clientp, progress_callback);
+	_c_yd_json_scope_end(&scope);
+	return ret;
+}
+
+int c_yd_client_download_public_resource(
+		c_yd_client_t *client, 
+		FILE *fp, 
+		const char * public_key, 
+		bool wait_finish, 
+		void *user_data, 
+		void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
+		void *clientp, 
+		int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char public_key_arg[BUFSIZ];
+	char *error = NULL;
+	cJSON *json;
+	struct _c_yd_json_scope scope;
+	int ret;
+	
+	_c_yd_query_arg(public_key_arg, sizeof(public_key_arg), "public_key", public_key);	
+
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/public/resources/download", NULL, &error, public_key_arg, NULL);
+	ret = _c_yandex_disk_transfer_file_parser(client, NULL, json, FILE_DOWNLOAD, wait_finish, NULL, fp, NULL, 0, error, user_data, callback, NULL, NULL, clientp, progress_callback);
+	_c_yd_json_scope_end(&scope);
+	return ret;
+}
+
+int c_yd_client_download_public_resource_data(c_yd_client_t *client, const char * public_key, bool wait_finish, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char public_key_arg[BUFSIZ];
+	char *error = NULL;
+	cJSON *json;
+	struct _c_yd_json_scope scope;
+	int ret;
+	
+	_c_yd_query_arg(public_key_arg, sizeof(public_key_arg), "public_key", public_key);	
+
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/public/resources/download", NULL, &error, public_key_arg, NULL);
+	ret = _c_yandex_disk_transfer_file_parser(client, NULL, json, DATA_DOWNLOAD, wait_finish, NULL, NULL, NULL, 0, error, user_data, NULL, callback, NULL, clientp, progress_callback);
+	_c_yd_json_scope_end(&scope);
+	return ret;
+}
+/* read n digits - return -1 if not digits */
+static int _c_yd_digits(const char **s, int n)
+{
+	int v = 0;
+	for (; n > 0; --n, ++*s) {
+		if (**s < '0' || **s > '9')
+			return -1;
+		v = v * 10 + (**s - '0');
+	}
+	return v;
+}
+
+/* days since 1970-01-01 of civil date (proleptic Gregorian) */
+static long _c_yd_days_from_civil(long y, int m, int d)
+{
+	long era, yoe, doy, doe;
+	
+	y -= m <= 2;
+	era = (y >= 0 ? y : y - 399) / 400;
+	yoe = y - era * 400;                                   //[0, 399]
+	doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1; //[0, 365]
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;           //[0, 146096]
+	return era * 146097 + doe - 719468;
+}
+
+/* days in month of Gregorian calendar */
+static int _c_yd_month_days(int y, int mon)
+{
+	static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+	if (mon == 2 && y % 4 == 0 && (y % 100 != 0 || y % 400 == 0))
+		return 29;
+	return days[mon - 1];
+}
+
+/* UTC time from ISO 8601 string like 2022-05-03T10:15:30.123+03:00
+ * - return 0 if string is not valid */
+static time_t _c_yd_time(const char *s)
+{
+	int y, mon, d, h, min, sec, off = 0;
+
+	if ((y   = _c_yd_digits(&s, 4)) < 0 || *s++ != '-' ||
+	    (mon = _c_yd_digits(&s, 2)) < 1 || mon > 12 || *s++ != '-' ||
+	    (d   = _c_yd_digits(&s, 2)) < 1 || d > _c_yd_month_days(y, mon))
+		return 0;
+	if (*s != 'T' && *s != 't' && *s != ' ')
+		return 0;
+	s++;
+	// second 60 is leap second
+	if ((h   = _c_yd_digits(&s, 2)) < 0 || h > 23 || *s++ != ':' ||
+	    (min = _c_yd_digits(&s, 2)) < 0 || min > 59 || *s++ != ':' ||
+	    (sec = _c_yd_digits(&s, 2)) < 0 || sec > 60)
+		return 0;
+
+	// fraction of second is dropped
+	if (*s == '.' || *s == ',')
+		for (s++; *s >= '0' && *s <= '9'; s++);
+
+	if (*s == '+' || *s == '-'){
+		int sign = *s++ == '-' ? -1 : 1;
+		int oh = _c_yd_digits(&s, 2), om = 0;
+		if (*s == ':')
+			s++;
+		if (*s)
+			om = _c_yd_digits(&s, 2);
+		if (oh < 0 || oh > 23 || om < 0 || om > 59)
+			return 0;
+		off = sign * (oh * 3600 + om * 60);
+	}
+
+	return (time_t)_c_yd_days_from_civil(y, mon, d) * 86400 + 
+		h * 3600 + min * 60 + sec - off;
+}
+
+/* resource fields */
+enum _c_yd_field {
+	YD_FIELD_UNKNOWN,
+	YD_FIELD_NAME,
+	YD_FIELD_TYPE,
+	YD_FIELD_PATH,
+	YD_FIELD_MIME_TYPE,
+	YD_FIELD_SIZE,
+	YD_FIELD_PREVIEW,
+	YD_FIELD_PUBLIC_KEY,
+	YD_FIELD_PUBLIC_URL,
+	YD_FIELD_MODIFIED,
+	YD_FIELD_CREATED,
+	YD_FIELD_MD5,
+	YD_FIELD_SHA256
+};
+
+/* field of key - key is selected by first char and length 
+ * and checked with one compare */
+static enum _c_yd_field _c_yd_field(const char *key)
+{
+	enum _c_yd_field field = YD_FIELD_UNKNOWN;
+	const char *name = NULL;
+	size_t len = strlen(key);
+
+	switch (key[0]) {
+		case 'c': 
+			field = YD_FIELD_CREATED;    name = "created";    break;
+		case 'm':
+			if (len == 3){
+				field = YD_FIELD_MD5;      name = "md5";
+			} else if (len == 8){
+				field = YD_FIELD_MODIFIED; name = "modified";
+			} else {
+				field = YD_FIELD_MIME_TYPE; name = "mime_type";
+			}
+			break;
+		case 'n': 
+			field = YD_FIELD_NAME;       name = "name";       break;
+		case 'p':
+			if (len == 4){
+				field = YD_FIELD_PATH;     name = "path";
+			} else if (len == 7){
+				field = YD_FIELD_PREVIEW;  name = "preview";
+			} else if (len == 10 && key[7] == 'k'){
+				field = YD_FIELD_PUBLIC_KEY; name = "public_key";
+			} else {
+				field = YD_FIELD_PUBLIC_URL; name = "public_url";
+			}
+			break;
+		case 's':
+			if (len == 4){
+				field = YD_FIELD_SIZE;     name = "size";
+			} else {
+				field = YD_FIELD_SHA256;   name = "sha256";
+			}
+			break;
+		case 't': 
+			field = YD_FIELD_TYPE;       name = "type";       break;
+		default:
+			return YD_FIELD_UNKNOWN;
+	}
+	return strcmp(key, name) == 0 ? field : YD_FIELD_UNKNOWN;
+}
+
+int c_json_to_c_yd_file_t(cJSON *json, c_yd_file_t *file)
+{
+	cJSON *item;
+
+	file->name[0] = '\0';
+	file->type[0] = '\0';
+	file->path[0] = '\0';
+	file->mime_type[0] = '\0';
+	file->preview[0] = '\0';
+	file->public_key[0] = '\0';
+	file->public_url[0] = '\0';
+	file->md5[0] = '\0';
+	file->sha256[0] = '\0';
+	file->size = 0;
+	file->modified = 0;
+	file->created = 0;
+
+	// one pass over members of resource
+	cJSON_ArrayForEach(item, json) {
+		char *dst = NULL;
+		size_t size = 0;
+
+		if (!item->string)
+			continue;
+		switch (_c_yd_field(item->string)) {
+			case YD_FIELD_NAME:
+				dst = file->name; size = sizeof(file->name); break;
+			case YD_FIELD_TYPE:
+				dst = file->type; size = sizeof(file->type); break;
+			case YD_FIELD_PATH:
+				dst = file->path; size = sizeof(file->path); break;
+			case YD_FIELD_MIME_TYPE:
+				dst = file->mime_type; size = sizeof(file->mime_type); break;
+			case YD_FIELD_PREVIEW:
+				dst = file->preview; size = sizeof(file->preview); break;
+			case YD_FIELD_PUBLIC_KEY:
+				dst = file->public_key; size = sizeof(file->public_key); break;
+			case YD_FIELD_PUBLIC_URL:
+				dst = file->public_url; size = sizeof(file->public_url); break;
+			case YD_FIELD_MD5:
+				dst = file->md5; size = sizeof(file->md5); break;
+			case YD_FIELD_SHA256:
+				dst = file->sha256; size = sizeof(file->sha256); break;
+			case YD_FIELD_SIZE:
+				// valueint is limited to INT_MAX
+				if (cJSON_IsNumber(item))
+					file->size = (size_t)item->valuedouble;
+				break;
+			case YD_FIELD_MODIFIED:
+				if (cJSON_IsString(item))
+					file->modified = _c_yd_time(item->valuestring);
+				break;
+			case YD_FIELD_CREATED:
+				if (cJSON_IsString(item))
+					file->created = _c_yd_time(item->valuestring);
+				break;
+			default:
+				break;
+		}
+		if (dst && cJSON_IsString(item))
+			snprintf(dst, size, "%s", item->valuestring);
+	}
+	
+	return 0;
+}
+
+int _c_yandex_disk_ls_parser(cJSON *json, char *error, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	cJSON *items = NULL,
+				*_embedded;
+
+	if (!json) { //no json returned
+		if (callback)
+			callback(NULL,user_data,STR("cYandexDisk: %s", error));
+		return -1;
+	}
+	if (cJSON_GetObjectItem(json, "error")){ //error to get info of file/directory
+		cJSON *message = cJSON_GetObjectItem(json, "message");			
+		if (callback)
+			callback(NULL,user_data,STR("cYandexDisk: %s", message ? message->valuestring : "unknown error"));
+		cJSON_Delete(json);
+		return  -1;
+	}	
+	items = NULL;
+	_embedded = cJSON_GetObjectItem(json, "_embedded");
+	if (_embedded)
+		items = cJSON_GetObjectItem(_embedded, "items");
+	else 
+		items = cJSON_GetObjectItem(json, "items");
+	if (items) { //we have items in directory
+		int i, count = cJSON_GetArraySize(items);
+		if (!count){
+			cJSON_Delete(json);
+			return 1;
+		}
+		
+		for (i = 0; i < count; ++i) {
+			cJSON *item = cJSON_GetArrayItem(items, i);
+			c_yd_file_t file;
+			c_json_to_c_yd_file_t(item, &file);
+			if (callback)
+				callback(&file, user_data, NULL);				
+		}
+	} else { //no items - return file info
+		c_yd_file_t file;
+		c_json_to_c_yd_file_t(json, &file);
+		if (callback)
+			callback(&file, user_data, NULL);
+	}	
+
+	cJSON_Delete(json);
+	return 0;
+}	
+static int
+_c_yd_file_info(
+		c_yd_client_t *client, 
+		const char * path,
+		const char * fields,
+		c_yd_file_t *file,
+		char **_error
+		)
+{
+	char path_arg[BUFSIZ], fields_arg[BUFSIZ];
+	char *error = NULL;
+	cJSON *json;
+	struct _c_yd_json_scope scope;
+	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+
+	_c_yd_json_scope_begin(&scope);
+	json = 
+		_c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/resources", NULL, &error, 
+				_c_yd_fields_arg(client, fields, path_arg, false, fields_arg, sizeof(fields_arg)), NULL);
+	if (error && _error) {
+		*_error = error;
+	}
+
+	if (!json) { //no json returned
+		_c_yd_json_scope_end(&scope);
+		return -1;
+	}
+	if (cJSON_GetObjectItem(json, "error")){ //error to get info of file/directory
+		cJSON *message = cJSON_GetObjectItem(json, "error");
+		if (_error)
+			*_error = strdup(message->valuestring);
+		cJSON_Delete(json);
+		_c_yd_json_scope_end(&scope);
+		return -1;
+	}	
+	
+	if (file)
+		c_json_to_c_yd_file_t(json, file);
+	cJSON_Delete(json);
+	_c_yd_json_scope_end(&scope);
+	return 0;
+}
+
+int c_yd_client_file_info(c_yd_client_t *client, const char * path, c_yd_file_t *file, char **error)
+{
+	struct _c_yd_cache_item *item;
+	unsigned long generation = 0;
+	c_yd_entry_t entry;
+	c_yd_file_t *info;
+	int ret;
+
+	if (!client->cache && !client->index)
+		return _c_yd_file_info(client, path, NULL, file, error);
+
+	item = _c_yd_cache_get(client, YD_CACHE_INFO, path, &generation);
+	if (item){
+		if (file)
+			_c_yd_entry_to_file(item->entries, file);
+		_c_yd_cache_release(client->cache, item);
+		return 0;
+	}
+
+	// info is cached if caller checks only that resource exists
+	info = file ? file : NEW(c_yd_file_t);
+	if (!info)
+		return _c_yd_file_info(client, path, NULL, NULL, error);
+	ret = _c_yd_file_info(client, path, NULL, info, error);
+	if (ret == 0){
+		_c_yd_file_to_entry(info, &entry);
+		_c_yd_cache_put(client, YD_CACHE_INFO, path, &entry, 1, generation);
+		_c_yd_index_put(client, NULL, &entry, 1);
+	}
+	if (info != file)
+		free(info);
+	return ret;
+}
+
+int c_yd_client_file_info_fields(c_yd_client_t *client, const char * path, const char * fields, c_yd_file_t *file, char **error)
+{
+	// cache and index keep resources with fields of client
+	if (!fields)
+		return c_yd_client_file_info(client, path, file, error);
+	return _c_yd_file_info(client, path, fields, file, error);
+}
+
+/* resumed download of file */
+struct _c_yd_resume {
+	CURL      *curl;
+	FILE      *fp;
+	curl_off_t start;     //bytes in local file before request
+	curl_off_t offset;    //bytes in local file
+	curl_off_t size;      //size of remote file
+	bool       aborted;   //stopped by progress callback
+	bool       no_range;  //server sent file from the beginning
+	void *clientp;
+	int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow);
+};
+
+static size_t _c_yd_resume_writefunc(
+		char *ptr, size_t size, size_t nmemb, struct _c_yd_resume *r)
+{
+	size_t len = size * nmemb;
+	long code = 0;
+
+	curl_easy_getinfo(r->curl, CURLINFO_RESPONSE_CODE, &code);
+	if (code >= 300)
+		return 0;
+	if (r->start > 0 && code != 206){
+		r->no_range = true;
+		return 0;
+	}
+
+	len = fwrite(ptr, 1, len, r->fp);
+	r->offset += len;
+
+	if (r->progress_callback && 
+			r->progress_callback(r->clientp, (double)r->size, (double)r->offset, 0, 0))
+	{
+		r->aborted = true;
+		return 0;
+	}
+	return len;
+}
+
+/* compare hash of local file with lowercase hex string - 
+ * SHA256 if it is known, MD5 otherwise */
+static int _c_yd_hash_check(const char *filepath, const c_yd_file_t *file)
+{
+	unsigned char buf[BUFSIZ], digest[SHA256_DIGEST_LEN];
+	char str[SHA256_DIGEST_LEN * 2 + 1];
+	bool sha = file->sha256[0] != 0;
+	sha256_t sha_ctx;
+	md5_t md5_ctx;
+	size_t len;
+	int i, n;
+	FILE *fp = fopen(filepath, "rb");
+	if (!fp)
+		return -1;
+
+	sha256_init(&sha_ctx);
+	md5_init(&md5_ctx);
+	while ((len = fread(buf, 1, sizeof(buf), fp)) > 0) {
+		if (sha)
+			sha256_update(&sha_ctx, buf, len);
+		else
+			md5_update(&md5_ctx, buf, len);
+	}
+	fclose(fp);
+	if (sha){
+		sha256_final(&sha_ctx, digest);
+		n = SHA256_DIGEST_LEN;
+	} else {
+		md5_final(&md5_ctx, digest);
+		n = MD5_DIGEST_LEN;
+	}
+
+	for (i = 0; i < n; ++i)
+		sprintf(str + i * 2, "%02x", digest[i]);
+	return strcmp(str, sha ? file->sha256 : file->md5) ? -1 : 0;
+}
+
+/* remote file of partial download is kept in filepath.ydresume - 
+ * partial file is continued only if remote file is not changed */
+static void _c_yd_resume_state(
+		const c_yd_file_t *file, char *buf, size_t size)
+{
+	snprintf(buf, size, "%lu %ld %s %s\n", 
+			(unsigned long)file->size, (long)file->modified,
+			file->md5[0] ? file->md5 : "-", 
+			file->sha256[0] ? file->sha256 : "-");
+}
+
+int c_yd_client_download_file_resume(c_yd_client_t *client, const char * filepath, const char * path, bool verify, char **error, void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	struct _c_yd_resume r;
+	struct stat file_info;
+	c_yd_file_t *file;
+	char *url = NULL, *err = NULL;
+	char statepath[BUFSIZ], state[256], saved[256];
+	bool restart = true;
+	FILE *fp;
+	CURL *curl;
+	CURLcode res = CURLE_OK;
+	long code = 0;
+	int i;
+
+	file = NEW(c_yd_file_t);
+	if (!file){
+		if (error)
+			*error = strdup("cYandexDisk: can't allocate memory");
+		return -1;
+	}
+	if (_c_yd_file_info(client, path, NULL, file, &err)){
+		if (error)
+			*error = err ? err : strdup("cYandexDisk: can't get file info");
+		else
+			free(err);
+		free(file);
+		return -1;
+	}
+	free(err);
+	err = NULL;
+
+	// partial file of same remote file not bigger than it
+	_c_yd_resume_state(file, state, sizeof(state));
+	snprintf(statepath, sizeof(statepath), "%s.ydresume", filepath);
+	if ((fp = fopen(statepath, "r"))){
+		if (fgets(saved, sizeof(saved), fp) && strcmp(saved, state) == 0 &&
+				stat(filepath, &file_info) == 0 && 
+				(curl_off_t)file_info.st_size <= (curl_off_t)file->size)
+			restart = false;
+		fclose(fp);
+	}
+	if (restart && (fp = fopen(statepath, "w"))){
+		fputs(state, fp);
+		fclose(fp);
+	}
+
+	// continue from the end of partial file
+	memset(&r, 0, sizeof(r));
+	r.fp = fopen(filepath, restart ? "wb" : "ab");
+	if (!r.fp || fstat(fileno(r.fp), &file_info)){
+		if (error)
+			*error = strdup(STR("cYandexDisk: can't open file: %s", strerror(errno)));
+		if (r.fp)
+			fclose(r.fp);
+		free(file);
+		return -1;
+	}
+	r.offset = file_info.st_size;
+	r.size = file->size;
+	r.clientp = clientp;
+	r.progress_callback = progress_callback;
+
+	for (i = 0; r.offset < r.size && i <= YD_RANGE_RETRIES; ++i) {
+		// download url expires - get new one for every try
+		free(url);
+		url = c_yd_client_file_url(client, path, &err);
+		if (!url)
+			break;
+
+		curl = _c_yd_pool_get(&client->pool);
+		if (!curl){
+			res = CURLE_FAILED_INIT;
+			break;
+		}
+		r.curl = curl;
+		r.start = r.offset;
+		curl_easy_setopt(curl, CURLOPT_URL, url);
+		curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, r.offset);
+		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _c_yd_resume_writefunc);
+		curl_easy_setopt(curl, CURLOPT_WRITEDATA, &r);
+		curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+		_c_yd_client_setopt(client, curl);
+		// no API timeout for file transfer
+		curl_easy_setopt(curl, CURLOPT_TIMEOUT, 0L);
+
+		res = curl_easy_perform(curl);
+		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+		_c_yd_pool_put(&client->pool, curl);
+		fflush(r.fp);
+
+		if (r.aborted || r.no_range)
+			break;
+	}
+	fclose(r.fp);
+	free(url);
+
+	if (r.offset != r.size){
+		if (error){
+			if (err){
+				*error = err;
+				err = NULL;
+			} else if (r.aborted)
+				*error = strdup("cYandexDisk: download aborted");
+			else if (r.no_range)
+				*error = strdup("cYandexDisk: server does not support resume");
+			else
+				*error = strdup(STR("cYandexDisk: download failed: %d (HTTP %ld)", res, code));
+		}
+		free(err);
+		free(file);
+		return -1;
+	}
+	free(err);
+	// file is complete - next download starts again
+	remove(statepath);
+
+	if (verify && (file->sha256[0] || file->md5[0]) && 
+			_c_yd_hash_check(filepath, file))
+	{
+		if (error)
+			*error = strdup(STR("cYandexDisk: %s of downloaded file does not match",
+						file->sha256[0] ? "SHA256" : "MD5"));
+		free(file);
+		return -1;
+	}
+
+	free(file);
+	return 0;
+}
+
+int c_yd_client_sort_ls_fields(c_yd_client_t *client, const char * path, const char *sort, int l, const char * fields, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	char path_sort_arg[BUFSIZ], fields_arg[BUFSIZ];
+	int i = 0, r = 0;
+	char limit[BUFSIZ], offset[BUFSIZ];
+	
+	_c_yd_query_arg(path_sort_arg, sizeof(path_sort_arg), "path", path);
+	snprintf(path_sort_arg + strlen(path_sort_arg), 
+			sizeof(path_sort_arg) - strlen(path_sort_arg), "&sort=%s", sort);	
+	sprintf(limit, "limit=%d", l<1?YD_ANSWER_LIMIT:l);
+	
+	do {
+		cJSON *json;
+		struct _c_yd_json_scope scope;
+		char *error = NULL;
+		
+		sprintf(offset, "offset=%d", i++ * l);
+		_c_yd_json_scope_begin(&scope);
+		json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk/resources", NULL, &error, limit, offset,
+				_c_yd_fields_arg(client, fields, path_sort_arg, true, fields_arg, sizeof(fields_arg)), NULL);
+		r = _c_yandex_disk_ls_parser(json, error, user_data, callback);
+		_c_yd_json_scope_end(&scope);
+	} while (r == 0 && l < 1);
+	return r;
+}
+
+int c_yd_client_sort_ls(c_yd_client_t *client, const char * path, const char *sort, int l, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	return c_yd_client_sort_ls_fields(client, path, sort, l, NULL, user_data, callback);
+}
+
+int c_yd_client_ls(c_yd_client_t *client, const char * path, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	return _c_yd_cache_ls(client, path, user_data, callback, NULL);
+}
+
+int c_yd_client_ls_fields(c_yd_client_t *client, const char * path, const char * fields, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	char path_arg[BUFSIZ];
+
+	// cache and index keep resources with fields of client
+	if (!fields)
+		return _c_yd_cache_ls(client, path, user_data, callback, NULL);
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_ls_pages(client, "v1/disk/resources", path_arg, fields, user_data, callback, NULL);
+}
+
+int c_yd_client_ls_public(c_yd_client_t *client, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	return _c_yd_ls_pages(client, "v1/disk/resources/public", NULL, NULL, user_data, callback, NULL);
+}
+
+int _c_yandex_disk_standart_parser(cJSON *json, char **error){
+	if (!json) //no json returned
+		return -1;
+
+	if (!cJSON_GetObjectItem(json, "href") && !cJSON_GetObjectItem(json, "path")){ //error to get info
+		cJSON *message = cJSON_GetObjectItem(json, "message");			
+		if (error)
+			*error = strdup(STR("cYandexDisk: %s", message->valuestring));
+		cJSON_Delete(json);
+		return  -1;		
+	}	
+	cJSON_Delete(json);
+	return 0;	
+}
+
+/* request answered with resource or link - answer is parsed 
+ * in request scope */
+static int _c_yd_status(c_yd_client_t *client, const char *path, const char *http_method, const char *api_suffix, const char *body, const char *arg, char **error)
+{
+	struct _c_yd_json_scope scope;
+	cJSON *json;
+	int ret;
+
+	// path is resource changed by request
+	_c_yd_cache_drop(client, path);
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, http_method, api_suffix, body, error, arg, NULL);
+	ret = _c_yandex_disk_standart_parser(json, error);
+	_c_yd_json_scope_end(&scope);
+	_c_yd_cache_drop(client, path);
+	return ret;
+}
+
+
+int c_yd_client_mkdir(c_yd_client_t *client, const char * path, char **error)
+{
+	char path_arg[BUFSIZ];
+	int ret;
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	ret = _c_yd_status(client, path, "PUT", "v1/disk/resources", NULL, path_arg, error);
+	if (ret == 0)
+		_c_yd_index_mkdir(client, path);
+	return ret;
+}
+
+int c_yd_client_rm(c_yd_client_t *client, const char * path, char **error)
+{
+	char path_arg[BUFSIZ];
+	int ret;
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	ret = _c_yd_status(client, path, "DELETE", "v1/disk/resources", NULL, path_arg, error);
+	_c_yd_index_forget(client, path);
+	return ret;
+}
+
+int c_yd_client_patch(c_yd_client_t *client, const char * path, const char *json_data, char **error)
+{
+	char path_arg[BUFSIZ];
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_status(client, path, "PATCH", "v1/disk/resources", json_data, path_arg, error);
+	return 0;
+}
+
+int c_yd_client_cp(c_yd_client_t *client, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char from_arg[BUFSIZ];
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	
+	_c_yd_query_arg(from_arg, sizeof(from_arg), "from", from);	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", to);	
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+
+	return _c_yd_operation(client, NULL, to, from, YD_INDEX_COPY, "v1/disk/resources/copy", from_arg, path_arg, overwrite_arg, user_data, callback);
+}
+
+int c_yd_client_mv(c_yd_client_t *client, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char from_arg[BUFSIZ];
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	
+	_c_yd_query_arg(from_arg, sizeof(from_arg), "from", from);	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", to);	
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+
+	return _c_yd_operation(client, from, to, from, YD_INDEX_MOVE, "v1/disk/resources/move", from_arg, path_arg, overwrite_arg, user_data, callback);
+}
+
+int c_yd_client_publish(c_yd_client_t *client, const char * path, char **error)
+{
+	char path_arg[BUFSIZ];
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+
+	return _c_yd_status(client, path, "PUT", "v1/disk/resources/publish", NULL, path_arg, error);
+}
+
+int c_yd_client_unpublish(c_yd_client_t *client, const char * path, char **error)
+{
+	char path_arg[BUFSIZ];
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+
+	return _c_yd_status(client, path, "PUT", "v1/disk/resources/unpublish", NULL, path_arg, error);
+}
+
+int c_yd_client_public_ls(c_yd_client_t *client, const char * public_key, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	char public_key_arg[BUFSIZ];
+	
+	_c_yd_query_arg(public_key_arg, sizeof(public_key_arg), "public_key", public_key);	
+	return _c_yd_ls_pages(client, "v1/disk/public/resources", public_key_arg, NULL, user_data, callback, NULL);
+}
+
+int c_yd_client_public_cp(c_yd_client_t *client, const char * public_key, const char * to, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char public_key_arg[BUFSIZ];
+	char save_path_arg[BUFSIZ];
+	
+	_c_yd_query_arg(public_key_arg, sizeof(public_key_arg), "public_key", public_key);	
+	_c_yd_query_arg(save_path_arg, sizeof(save_path_arg), "save_path", to);	
+
+	return _c_yd_operation(client, NULL, to, NULL, YD_INDEX_FORGET, "v1/disk/resources/copy", public_key_arg, save_path_arg, NULL, user_data, callback);
+}
+
+int c_yd_client_trash_ls(
+		c_yd_client_t *client, 
+		void * user_data,          
+		int(*callback)(			       
+			const c_yd_file_t *file, 
+			void * user_data,	       
+			const char * error)
+		)
+{
+	return _c_yd_ls_pages(client, "v1/disk/trash/resources", NULL, NULL, user_data, callback, NULL);
+}	
+
+int c_yd_client_trash_restore(c_yd_client_t *client, const char * path, char **error)
+{
+	char path_arg[BUFSIZ];
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	// resource is restored to unknown path
+	return _c_yd_status(client, "/", "PUT", "v1/disk/trash/resources", NULL, path_arg, error);
+}
+
+int c_yd_client_trash_empty(c_yd_client_t *client, char **error)
+{
+	return _c_yd_status(client, NULL, "DELETE", "v1/disk/trash/resources", NULL, NULL, error);
+}
+
+/* asynchronous engine - one driver thread runs all 
+ * asynchronous requests of client with curl_multi */
+
+struct _c_yd_request {
+	c_yd_client_t *client;
+	char        url[BUFSIZ];
+	const char *method;      //API request method or NULL for transfer
+	char       *body;        //request body
+	struct str  s;           //answer
+	long        when;        //do not start before (monotonic ms)
+	void       *data;        //operation context
+	//API answer callback - called in driver thread
+	void (*on_json)(struct _c_yd_request *req, cJSON *json, long code, const char *error);
+	//set additional curl options
+	void (*setup)(struct _c_yd_request *req, CURL *curl);
+	//request finished - called in driver thread
+	void (*on_done)(struct _c_yd_request *req, CURL *curl, CURLcode res);
+	struct _c_yd_request *next;
+};
+
+struct _c_yd_engine {
+	pthread_mutex_t lock;
+	pthread_cond_t  cond;      //signaled when request finished
+	pthread_t       thread;
+	CURLM          *multi;
+	struct _c_yd_request *queue;    //submitted requests
+	struct _c_yd_request *tail;
+	int             active;    //number of unfinished requests
+	bool            stop;
+	bool            detached;  //engine destroyed from driver thread
+	struct _c_yd_request *deferred; //driver thread only
+	CURL          **handles;   //idle handles - driver thread only
+	int             count;
+	int             size;
+};
+
+/* monotonic time in milliseconds */
+static long _c_yd_now_ms(void)
+{
+#ifdef _WIN32
+	return (long)GetTickCount();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+static void _c_yd_engine_free(struct _c_yd_engine *engine)
+{
+	while (engine->count > 0)
+		curl_easy_cleanup(engine->handles[--engine->count]);
+	free(engine->handles);
+	curl_multi_cleanup(engine->multi);
+	pthread_mutex_destroy(&engine->lock);
+	pthread_cond_destroy(&engine->cond);
+	free(engine);
+}
+
+/* start request in multi */
+static void _c_yd_engine_add(
+		struct _c_yd_engine *engine, struct _c_yd_request *req)
+{
+	CURL *curl = NULL;
+	c_yd_client_t *client = req->client;
+
+	if (engine->count > 0)
+		curl = engine->handles[--engine->count];
+	else 
+		curl = curl_easy_init();
+	
+	if (!curl){
+		req->on_done(req, NULL, CURLE_FAILED_INIT);
+		free(req->s.str);
+		free(req->body);
+		free(req);
+		pthread_mutex_lock(&engine->lock);
+		engine->active--;
+		pthread_cond_broadcast(&engine->cond);
+		pthread_mutex_unlock(&engine->lock);
+		_c_yd_client_unref(client);
+		return;
+	}
+
+	curl_easy_setopt(curl, CURLOPT_URL, req->url);
+	curl_easy_setopt(curl, CURLOPT_PRIVATE, req);
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);		
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writefunc);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &req->s);
+	if (req->method){
+		curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, req->method);		
+		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, client->header);
+	}
+	if (req->body) {
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req->body);
+		curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, strlen(req->body));
+	}
+	_c_yd_client_setopt(client, curl);
+#if LIBCURL_VERSION_NUM >= 0x072B00
+	/* wait for connection in use to multiplex API request
+	 * as new stream instead of opening new connection */
+	if (req->method && client->config.http2)
+		curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+#endif
+	if (req->setup)
+		req->setup(req, curl);
+
+	curl_multi_add_handle(engine->multi, curl);
+}
+
+/* request finished */
+static void _c_yd_engine_done(
+		struct _c_yd_engine *engine, CURL *curl, CURLcode res)
+{
+	struct _c_yd_request *req = NULL;
+	c_yd_client_t *client;
+
+	curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char **)&req);
+	curl_multi_remove_handle(engine->multi, curl);
+	
+	req->on_done(req, curl, res);
+
+	// keep handle for next request
+	curl_easy_reset(curl);
+	if (engine->count < engine->size)
+		engine->handles[engine->count++] = curl;
+	else
+		curl_easy_cleanup(curl);
+
+	client = req->client;
+	free(req->s.str);
+	free(req->body);
+	free(req);
+
+	pthread_mutex_lock(&engine->lock);
+	engine->active--;
+	pthread_cond_broadcast(&engine->cond);
+	pthread_mutex_unlock(&engine->lock);
+	
+	// may destroy client and engine
+	_c_yd_client_unref(client);
+}
+
+static void *_c_yd_engine_thread(void *_engine)
+{
+	struct _c_yd_engine *engine = _engine;
+
+	for (;;) {
+		int running, left;
+		long now, timeout = 1000;
+		bool stop;
+		CURLMsg *msg;
+		struct _c_yd_request *req, *next, **pp;
+
+		pthread_mutex_lock(&engine->lock);
+		req = engine->queue;
+		engine->queue = engine->tail = NULL;
+		stop = engine->stop;
+		pthread_mutex_unlock(&engine->lock);
+		if (stop)
+			break;
+
+		// deferred requests wait for their time
+		now = _c_yd_now_ms();
+		for (; req; req = next) {
+			next = req->next;
+			if (req->when <= now)
+				_c_yd_engine_add(engine, req);
+			else {
+				req->next = engine->deferred;
+				engine->deferred = req;
+			}
+		}
+		pp = &engine->deferred;
+		while (*pp) {
+			req = *pp;
+			if (req->when <= now){
+				*pp = req->next;
+				_c_yd_engine_add(engine, req);
+			} else {
+				if (req->when - now < timeout)
+					timeout = req->when - now;
+				pp = &req->next;
+			}
+		}
+
+		curl_multi_perform(engine->multi, &running);
+		while ((msg = curl_multi_info_read(engine->multi, &left))) {
+			if (msg->msg == CURLMSG_DONE)
+				_c_yd_engine_done(engine, msg->easy_handle, msg->data.result);
+		}
+		
+		if (engine->detached)
+			break;
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+		curl_multi_poll(engine->multi, NULL, 0, timeout, NULL);
+#else
+		curl_multi_wait(engine->multi, NULL, 0, timeout < 100 ? timeout : 100, NULL);
+#endif
+	}
+
+	if (engine->detached)
+		_c_yd_engine_free(engine);
+	return NULL;
+}
+
+static struct _c_yd_engine *_c_yd_engine_new(c_yd_client_t *client)
+{
+	pthread_attr_t attr;
+	struct _c_yd_engine *engine = NEW(struct _c_yd_engine);
+	if (!engine)
+		return NULL;
+
+	engine->size = client->config.max_connections;
+	engine->handles = MALLOC(sizeof(CURL *) * engine->size);
+	engine->multi = curl_multi_init();
+	if (!engine->handles || !engine->multi){
+		free(engine->handles);
+		if (engine->multi)
+			curl_multi_cleanup(engine->multi);
+		free(engine);
+		return NULL;
+	}
+	
+#if LIBCURL_VERSION_NUM >= 0x071E00
+	if (client->config.concurrency > 0)
+		curl_multi_setopt(engine->multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, 
+				(long)client->config.concurrency);
+#endif
+
+	if (client->config.http2){
+#if LIBCURL_VERSION_NUM >= 0x072B00
+		curl_multi_setopt(engine->multi, CURLMOPT_PIPELINING, 
+				CURLPIPE_MULTIPLEX);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x074300
+		if (client->config.max_streams > 0)
+			curl_multi_setopt(engine->multi, CURLMOPT_MAX_CONCURRENT_STREAMS, 
+					(long)client->config.max_streams);
+#endif
+	}
+
+	pthread_mutex_init(&engine->lock, NULL);
+	pthread_cond_init(&engine->cond, NULL);
+
+	pthread_attr_init(&attr);
+	if (pthread_create(&engine->thread, &attr, _c_yd_engine_thread, engine)){
+		perror("create THREAD");
+		pthread_attr_destroy(&attr);
+		_c_yd_engine_free(engine);
+		return NULL;
+	}
+	pthread_attr_destroy(&attr);
+
+	return engine;
+}
+
+/* stop driver thread and free engine - client has no
+ * active requests here */
+static void _c_yd_engine_destroy(struct _c_yd_engine *engine)
+{
+	if (pthread_equal(pthread_self(), engine->thread)){
+		// last client reference dropped in callback - driver
+		// thread frees engine itself
+		engine->detached = true;
+		pthread_detach(engine->thread);
+		return;
+	}
+	
+	pthread_mutex_lock(&engine->lock);
+	engine->stop = true;
+	pthread_mutex_unlock(&engine->lock);
+#if LIBCURL_VERSION_NUM >= 0x074400
+	curl_multi_wakeup(engine->multi);
+#endif
+	pthread_join(engine->thread, NULL);
+	_c_yd_engine_free(engine);
+}
+
+/* return client engine - start it on first use */
+static struct _c_yd_engine *_c_yd_client_engine(c_yd_client_t *client)
+{
+	struct _c_yd_engine *engine;
+	
+	pthread_mutex_lock(&client->lock);
+	if (!client->engine)
+		client->engine = _c_yd_engine_new(client);
+	engine = client->engine;
+	pthread_mutex_unlock(&client->lock);
+
+	return engine;
+}
+
+static struct _c_yd_request *_c_yd_request_new(void *data)
+{
+	struct _c_yd_request *req = NEW(struct _c_yd_request);
+	if (!req)
+		return NULL;
+	if (str_init(&req->s)){
+		free(req);
+		return NULL;
+	}
+	req->data = data;
+	return req;
+}
+
+/* queue request to engine - req is freed after on_done */
+static int _c_yd_engine_submit(
+		c_yd_client_t *client, struct _c_yd_request *req, long delay)
+{
+	struct _c_yd_engine *engine = _c_yd_client_engine(client);
+	if (!engine){
+		free(req->s.str);
+		free(req->body);
+		free(req);
+		return -1;
+	}
+
+	req->client = _c_yd_client_ref(client);
+	req->when = delay > 0 ? _c_yd_now_ms() + delay : 0;
+	req->next = NULL;
+	
+	pthread_mutex_lock(&engine->lock);
+	if (engine->tail)
+		engine->tail->next = req;
+	else
+		engine->queue = req;
+	engine->tail = req;
+	engine->active++;
+	pthread_mutex_unlock(&engine->lock);
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+	curl_multi_wakeup(engine->multi);
+#endif
+	return 0;
+}
+
+static void _c_yd_engine_api_done(
+		struct _c_yd_request *req, CURL *curl, CURLcode res)
+{
+	long code = 0;
+	cJSON *json;
+	struct _c_yd_json_scope scope;
+	char error[64];
+	
+	if (res != CURLE_OK){
+		snprintf(error, sizeof(error), 
+				"curl returned error: %d", res);
+		req->on_json(req, NULL, 0, error);
+		return;
+	}
+	
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_json_parse(req->client, &scope, req->s.str, req->s.len);
+	// on_json owns json
+	req->on_json(req, json, code, NULL);
+	_c_yd_json_scope_end(&scope);
+}
+
+/* queue API request - NULL-terminated list of arguments */
+static int _c_yd_engine_api(
+		c_yd_client_t *client, const char *http_method, 
+		const char *api_suffix, const char *body, long delay,
+		void *data, 
+		void (*on_json)(struct _c_yd_request *req, cJSON *json, long code, const char *error),
+		...)
+{
+	va_list argv;
+	struct _c_yd_request *req = _c_yd_request_new(data);
+	if (!req)
+		return -1;
+
+	va_start(argv, on_json);
+	_c_yd_api_url(req->url, sizeof(req->url), api_suffix, argv);
+	va_end(argv);
+
+	req->method = http_method;
+	req->on_json = on_json;
+	req->on_done = _c_yd_engine_api_done;
+	if (body){
+		req->body = strdup(body);
+		if (!req->body){
+			free(req->s.str);
+			free(req);
+			return -1;
+		}
+	}
+
+	return _c_yd_engine_submit(client, req, delay);
+}
+
+/* queue GET request with own on_done - answer is in req->s */
+static int _c_yd_engine_get(
+		c_yd_client_t *client, const char *api_suffix, void *data,
+		void (*on_done)(struct _c_yd_request *req, CURL *curl, CURLcode res),
+		...)
+{
+	va_list argv;
+	struct _c_yd_request *req = _c_yd_request_new(data);
+	if (!req)
+		return -1;
+
+	va_start(argv, on_done);
+	_c_yd_api_url(req->url, sizeof(req->url), api_suffix, argv);
+	va_end(argv);
+
+	req->method = "GET";
+	req->on_done = on_done;
+	return _c_yd_engine_submit(client, req, 0);
+}
+
+/* synchronous request with engine */
+struct _c_yd_engine_call {
+	pthread_mutex_t lock;
+	pthread_cond_t  cond;      //signaled when request finished
+	bool            done;
+	char           *answer;
+	size_t          len;
+	long            code;      //HTTP response code
+	CURLcode        res;
+};
+
+static void _c_yd_engine_call_done(
+		struct _c_yd_request *req, CURL *curl, CURLcode res)
+{
+	struct _c_yd_engine_call *call = req->data;
+
+	pthread_mutex_lock(&call->lock);
+	call->res = res;
+	if (res == CURLE_OK){
+		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &call->code);
+		// take answer
+		call->answer = req->s.str;
+		call->len = req->s.len;
+		req->s.str = NULL;
+	}
+	call->done = true;
+	pthread_cond_signal(&call->cond);
+	pthread_mutex_unlock(&call->lock);
+}
+
+/* make request with engine and wait for answer - return 
+ * answer (free it) or NULL on error */
+static char *_c_yd_engine_call(
+		c_yd_client_t *client, const char * http_method, 
+		const char *api_suffix, const char *body, size_t *len,
+		long *code, char **error, va_list argv)
+{
+	struct _c_yd_engine_call call;
+	struct _c_yd_request *req;
+
+	memset(&call, 0, sizeof(call));
+	req = _c_yd_request_new(&call);
+	if (!req || (body && !(req->body = strdup(body)))){
+		if (req){
+			free(req->s.str);
+			free(req);
+		}
+		if (error)
+			*error = strdup("cYandexDisk: can't allocate memory");
+		return NULL;
+	}
+	_c_yd_api_url(req->url, sizeof(req->url), api_suffix, argv);
+	req->method = http_method;
+	req->on_done = _c_yd_engine_call_done;
+
+	pthread_mutex_init(&call.lock, NULL);
+	pthread_cond_init(&call.cond, NULL);
+	if (_c_yd_engine_submit(client, req, 0)){
+		if (error)
+			*error = strdup("cYandexDisk: can't queue request");
+	} else {
+		pthread_mutex_lock(&call.lock);
+		while (!call.done)
+			pthread_cond_wait(&call.cond, &call.lock);
+		pthread_mutex_unlock(&call.lock);
+		if (call.res != CURLE_OK && error)
+			*error = strdup(STR("cYandexDisk: curl returned error: %d", call.res));
+	}
+	pthread_mutex_destroy(&call.lock);
+	pthread_cond_destroy(&call.cond);
+
+	*len = call.len;
+	if (code)
+		*code = call.code;
+	return call.answer;
+}
+
+void c_yd_client_wait_async(c_yd_client_t *client)
+{
+	struct _c_yd_engine *engine;
+	
+	pthread_mutex_lock(&client->lock);
+	engine = client->engine;
+	pthread_mutex_unlock(&client->lock);
+	if (!engine)
+		return;
+
+	pthread_mutex_lock(&engine->lock);
+	while (engine->active > 0)
+		pthread_cond_wait(&engine->cond, &engine->lock);
+	pthread_mutex_unlock(&engine->lock);
+}
+
+/* error message from API answer */
+static const char *_c_yd_json_message(
+		cJSON *json, long code, char *buf, size_t size)
+{
+	cJSON *message = cJSON_GetObjectItem(json, "message");
+	if (message && message->valuestring)
+		snprintf(buf, size, "cYandexDisk: %s", message->valuestring);
+	else
+		snprintf(buf, size, "cYandexDisk: HTTP error: %ld", code);
+	return buf;
+}
+
+/* asynchronous operations with status callback */
+struct _c_yd_status_async {
+	void *user_data;
+	int(*callback)(void *user_data, const char *error);
+	char operation[256]; //operation status url suffix
+	long interval;       //operation status poll interval
+	char *changed[2];    //resources changed by request
+	char *source;        //copied resource
+	int   index_op;
+	c_yd_job_t *job;     //handle of operation or NULL
+};
+
+static struct _c_yd_status_async *_c_yd_status_async_new(
+		c_yd_client_t *client, const char *from, const char *to,
+		const char *source, int index_op,
+		void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	struct _c_yd_status_async *ctx = 
+		NEW(struct _c_yd_status_async);
+	if (!ctx)
+		return NULL;
+	ctx->user_data = user_data;
+	ctx->callback = callback;
+	ctx->index_op = index_op;
+	if (from)
+		ctx->changed[0] = strdup(from);
+	if (to)
+		ctx->changed[1] = strdup(to);
+	if (source)
+		ctx->source = strdup(source);
+	_c_yd_cache_drop(client, from);
+	_c_yd_cache_drop(client, to);
+	return ctx;
+}
+
+/* request finished - drop changed resources from cache and
+ * change index (resources are removed if request failed) */
+static void _c_yd_status_async_drop(
+		c_yd_client_t *client, struct _c_yd_status_async *ctx, bool ok)
+{
+	_c_yd_cache_drop(client, ctx->changed[0]);
+	_c_yd_cache_drop(client, ctx->changed[1]);
+	
+	if (ctx->index_op == YD_INDEX_NONE)
+		return;
+	if (ok && ctx->index_op == YD_INDEX_MKDIR && ctx->changed[1])
+		_c_yd_index_mkdir(client, ctx->changed[1]);
+	else if (ok && ctx->index_op == YD_INDEX_COPY && ctx->source && ctx->changed[1])
+		_c_yd_index_move(client, ctx->source, ctx->changed[1], true);
+	else if (ok && ctx->index_op == YD_INDEX_MOVE && ctx->changed[0] && ctx->changed[1])
+		_c_yd_index_move(client, ctx->changed[0], ctx->changed[1], false);
+	else {
+		_c_yd_index_forget(client, ctx->changed[0]);
+		_c_yd_index_forget(client, ctx->changed[1]);
+	}
+}
+
+static void _c_yd_status_async_free(struct _c_yd_status_async *ctx)
+{
+	if (ctx->job)
+		_c_yd_job_unref(ctx->job);
+	free(ctx->changed[0]);
+	free(ctx->changed[1]);
+	free(ctx->source);
+	free(ctx);
+}
+
+/* request or operation finished - error is NULL on success */
+static void _c_yd_status_async_done(
+		c_yd_client_t *client, struct _c_yd_status_async *ctx, 
+		const char *error)
+{
+	_c_yd_status_async_drop(client, ctx, !error);
+	if (ctx->callback)
+		ctx->callback(ctx->user_data, error);
+	if (ctx->job){
+		_c_yd_job_result(ctx->job, 0, error);
+		_c_yd_job_finish(ctx->job);
+		ctx->job = NULL;
+	}
+	_c_yd_status_async_free(ctx);
+}
+
+static void _c_yd_status_async_on_json(
+		struct _c_yd_request *req, cJSON *json, long code, const char *error)
+{
+	struct _c_yd_status_async *ctx = req->data;
+	char buf[BUFSIZ];
+	
+	if (error)
+		snprintf(buf, sizeof(buf), "cYandexDisk: %s", error);
+	else if (code >= 300)
+		_c_yd_json_message(json, code, buf, sizeof(buf));
+	
+	if (json)
+		cJSON_Delete(json);
+	_c_yd_status_async_done(req->client, ctx, 
+			error || code >= 300 ? buf : NULL);
+}
+
+static int _c_yd_status_async(
+		c_yd_client_t *client, const char *path, int index_op,
+		const char *http_method, const char *api_suffix, const char *body, 
+		const char *arg,
+		void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	struct _c_yd_status_async *ctx = 
+		_c_yd_status_async_new(client, NULL, path, NULL, index_op, user_data, callback);
+	if (!ctx)
+		return -1;
+
+	if (_c_yd_engine_api(client, http_method, api_suffix, body, 0, 
+				ctx, _c_yd_status_async_on_json, arg, NULL))
+	{
+		_c_yd_status_async_free(ctx);
+		return -1;
+	}
+	return 0;
+}
+
+int c_yd_client_mkdir_async(c_yd_client_t *client, const char * path, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char path_arg[BUFSIZ];
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_status_async(client, path, YD_INDEX_MKDIR, "PUT", "v1/disk/resources", NULL, path_arg, user_data, callback);
+}
+
+int c_yd_client_rm_async(c_yd_client_t *client, const char * path, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char path_arg[BUFSIZ];
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_status_async(client, path, YD_INDEX_FORGET, "DELETE", "v1/disk/resources", NULL, path_arg, user_data, callback);
+}
+
+int c_yd_client_patch_async(c_yd_client_t *client, const char * path, const char *json_data, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char path_arg[BUFSIZ];
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_status_async(client, path, YD_INDEX_NONE, "PATCH", "v1/disk/resources", json_data, path_arg, user_data, callback);
+}
+
+int c_yd_client_publish_async(c_yd_client_t *client, const char * path, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char path_arg[BUFSIZ];
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_status_async(client, path, YD_INDEX_NONE, "PUT", "v1/disk/resources/publish", NULL, path_arg, user_data, callback);
+}
+
+int c_yd_client_unpublish_async(c_yd_client_t *client, const char * path, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char path_arg[BUFSIZ];
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_status_async(client, path, YD_INDEX_NONE, "PUT", "v1/disk/resources/unpublish", NULL, path_arg, user_data, callback);
+}
+
+int c_yd_client_trash_restore_async(c_yd_client_t *client, const char * path, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char path_arg[BUFSIZ];
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_status_async(client, "/", YD_INDEX_NONE, "PUT", "v1/disk/trash/resources", NULL, path_arg, user_data, callback);
+}
+
+int c_yd_client_trash_empty_async(c_yd_client_t *client, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	return _c_yd_status_async(client, NULL, YD_INDEX_NONE, "DELETE", "v1/disk/trash/resources", NULL, NULL, user_data, callback);
+}
+
+/* operations of copy/move are polled by engine thread - delay 
+ * of next status request grows while operation is in progress, 
+ * time of request is rounded to tick so statuses of many 
+ * operations are asked together in one pass of engine */
+static long _c_yd_operation_delay(struct _c_yd_status_async *ctx)
+{
+	long now = _c_yd_now_ms();
+	long when = now + ctx->interval;
+	
+	when += YD_OPERATION_TICK - when % YD_OPERATION_TICK;
+	ctx->interval *= 2;
+	if (ctx->interval > YD_OPERATION_INTERVAL_MAX)
+		ctx->interval = YD_OPERATION_INTERVAL_MAX;
+	return when - now;
+}
+
+static void _c_yd_operation_async_on_json(
+		struct _c_yd_request *req, cJSON *json, long code, const char *error);
+
+/* queue next request of operation status */
+static int _c_yd_operation_poll(
+		c_yd_client_t *client, struct _c_yd_status_async *ctx)
+{
+	return _c_yd_engine_api(client, "GET", ctx->operation, NULL, 
+			_c_yd_operation_delay(ctx), ctx, _c_yd_operation_async_on_json, NULL);
+}
+
+/* href of answer is link to operation status - set operation */
+static bool _c_yd_operation_href(
+		struct _c_yd_status_async *ctx, cJSON *json)
+{
+	cJSON *href = cJSON_GetObjectItem(json, "href");
+	const char *operation;
+
+	if (!href || !href->valuestring ||
+			!(operation = strstr(href->valuestring, "v1/disk/operations/")))
+		return false;
+	snprintf(ctx->operation, sizeof(ctx->operation), "%s", operation);
+	return true;
+}
+
+/* copy/move - wait for operation finished */
+static void _c_yd_operation_async_on_json(
+		struct _c_yd_request *req, cJSON *json, long code, const char *error)
+{
+	struct _c_yd_status_async *ctx = req->data;
+	char buf[BUFSIZ];
+	cJSON *status = cJSON_GetObjectItem(json, "status");
+	
+	// cancelled job does not wait for operation
+	if (ctx->job){
+		pthread_mutex_lock(&ctx->job->lock);
+		if (ctx->job->cancelled && !error)
+			error = "operation cancelled";
+		pthread_mutex_unlock(&ctx->job->lock);
+	}
+
+	if (!error && code < 300 && status && status->valuestring &&
+			strcmp(status->valuestring, "in-progress") == 0)
+	{
+		// ask again later
+		if (_c_yd_operation_poll(req->client, ctx) == 0){
+			cJSON_Delete(json);
+			return;
+		}
+		error = "can't queue request";
+	}
+
+	if (error)
+		snprintf(buf, sizeof(buf), "cYandexDisk: %s", error);
+	else if (code >= 300)
+		_c_yd_json_message(json, code, buf, sizeof(buf));
+	else if (status && status->valuestring && 
+			strcmp(status->valuestring, "success") != 0)
+		snprintf(buf, sizeof(buf), "cYandexDisk: operation %s", status->valuestring);
+	else
+		buf[0] = 0;
+
+	if (json)
+		cJSON_Delete(json);
+	_c_yd_status_async_done(req->client, ctx, buf[0] ? buf : NULL);
+}
+
+static void _c_yd_cp_async_on_json(
+		struct _c_yd_request *req, cJSON *json, long code, const char *error)
+{
+	struct _c_yd_status_async *ctx = req->data;
+	
+	// 202 - operation started, href is link to operation status
+	if (!error && code == 202 && _c_yd_operation_href(ctx, json)){
+		if (_c_yd_operation_poll(req->client, ctx) == 0){
+			cJSON_Delete(json);
+			return;
+		}
+		error = "can't queue request";
+	}
+
+	_c_yd_status_async_on_json(req, json, code, error);
+}
+
+static int _c_yd_cp_async(
+		c_yd_client_t *client, const char *from, const char *to,
+		const char *source, int index_op, c_yd_job_t **job,
+		const char *api_suffix, 
+		const char *arg1, const char *arg2, const char *arg3, 
+		void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	struct _c_yd_status_async *ctx = 
+		_c_yd_status_async_new(client, from, to, source, index_op, user_data, callback);
+	if (!ctx)
+		return -1;
+	ctx->interval = YD_OPERATION_INTERVAL;
+	
+	// request and job handle reference job
+	if (job){
+		if (!(ctx->job = _c_yd_job_new(C_YD_JOB_RUNNING))){
+			_c_yd_status_async_free(ctx);
+			return -1;
+		}
+		ctx->job->refs++;
+		*job = ctx->job;
+	}
+
+	if (_c_yd_engine_api(client, "POST", api_suffix, NULL, 0, ctx, 
+				_c_yd_cp_async_on_json, arg1, arg2, arg3, "force_async=true", NULL))
+	{
+		if (job){
+			_c_yd_job_unref(*job);
+			*job = NULL;
+		}
+		_c_yd_status_async_free(ctx);
+		return -1;
+	}
+	return 0;
+}
+
+/* copy/move - request is made in caller thread, operation
+ * status is polled by engine and callback is called when
+ * operation finished; callback is called in caller thread
+ * if request failed or resource is copied at once */
+static int _c_yd_operation(
+		c_yd_client_t *client, const char *from, const char *to,
+		const char *source, int index_op,
+		const char *api_suffix, 
+		const char *arg1, const char *arg2, const char *arg3, 
+		void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	struct _c_yd_json_scope scope;
+	struct _c_yd_status_async *ctx;
+	cJSON *json;
+	char *error = NULL;
+	char buf[BUFSIZ];
+
+	ctx = _c_yd_status_async_new(client, from, to, source, index_op, user_data, callback);
+	if (!ctx){
+		if (callback)
+			callback(user_data, "cYandexDisk: can't allocate memory");
+		return -1;
+	}
+	ctx->interval = YD_OPERATION_INTERVAL;
+
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "POST", api_suffix, NULL, &error, 
+			arg1, arg2, arg3, "force_async=true", NULL);
+	
+	if (_c_yd_operation_href(ctx, json)){
+		if (_c_yd_operation_poll(client, ctx) == 0){
+			cJSON_Delete(json);
+			_c_yd_json_scope_end(&scope);
+			return 0;
+		}
+		snprintf(buf, sizeof(buf), "cYandexDisk: can't queue request");
+	}
+	else if (error)
+		snprintf(buf, sizeof(buf), "%s", error);
+	else if (!json)
+		snprintf(buf, sizeof(buf), "cYandexDisk: no answer");
+	// link to resource - copied without operation
+	else if (!cJSON_GetObjectItem(json, "href"))
+		_c_yd_json_message(json, 0, buf, sizeof(buf));
+	else
+		buf[0] = 0;
+	
+	if (json)
+		cJSON_Delete(json);
+	_c_yd_json_scope_end(&scope);
+	free(error);
+
+	_c_yd_status_async_done(client, ctx, buf[0] ? buf : NULL);
+	return buf[0] ? -1 : 0;
+}
+
+int c_yd_client_cp_async(c_yd_client_t *client, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char from_arg[BUFSIZ];
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	
+	_c_yd_query_arg(from_arg, sizeof(from_arg), "from", from);	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", to);	
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	return _c_yd_cp_async(client, NULL, to, from, YD_INDEX_COPY, NULL, "v1/disk/resources/copy", from_arg, path_arg, overwrite_arg, user_data, callback);
+}
+
+int c_yd_client_mv_async(c_yd_client_t *client, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char from_arg[BUFSIZ];
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	
+	_c_yd_query_arg(from_arg, sizeof(from_arg), "from", from);	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", to);	
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	return _c_yd_cp_async(client, from, to, from, YD_INDEX_MOVE, NULL, "v1/disk/resources/move", from_arg, path_arg, overwrite_arg, user_data, callback);
+}
+
+c_yd_job_t *c_yd_client_cp_job(c_yd_client_t *client, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char from_arg[BUFSIZ];
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	c_yd_job_t *job = NULL;
+	
+	_c_yd_query_arg(from_arg, sizeof(from_arg), "from", from);	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", to);	
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	_c_yd_cp_async(client, NULL, to, from, YD_INDEX_COPY, &job, "v1/disk/resources/copy", from_arg, path_arg, overwrite_arg, user_data, callback);
+	return job;
+}
+
+c_yd_job_t *c_yd_client_mv_job(c_yd_client_t *client, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char from_arg[BUFSIZ];
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	c_yd_job_t *job = NULL;
+	
+	_c_yd_query_arg(from_arg, sizeof(from_arg), "from", from);	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", to);	
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	_c_yd_cp_async(client, from, to, from, YD_INDEX_MOVE, &job, "v1/disk/resources/move", from_arg, path_arg, overwrite_arg, user_data, callback);
+	return job;
+}
+
+int c_yd_client_public_cp_async(c_yd_client_t *client, const char * public_key, const char * to, void *user_data, int(*callback)(void *user_data, const char *error))
+{
+	char public_key_arg[BUFSIZ];
+	char save_path_arg[BUFSIZ];
+	
+	_c_yd_query_arg(public_key_arg, sizeof(public_key_arg), "public_key", public_key);	
+	_c_yd_query_arg(save_path_arg, sizeof(save_path_arg), "save_path", to);	
+	return _c_yd_cp_async(client, NULL, to, NULL, YD_INDEX_FORGET, NULL, "v1/disk/public/resources/save-to-disk", public_key_arg, save_path_arg, NULL, user_data, callback);
+}
+
+/* file info and listings */
+struct _c_yd_ls_async {
+	char  api_suffix[64];
+	char  arg[BUFSIZ];
+	int   offset;
+	bool  info;            //single resource
+	void *user_data;
+	int(*callback)(const c_yd_file_t *file, void * user_data, const char * error);
+};
+
+static void _c_yd_ls_async_on_json(
+		struct _c_yd_request *req, cJSON *json, long code, const char *error)
+{
+	struct _c_yd_ls_async *ctx = req->data;
+	char buf[BUFSIZ];
+	cJSON *_embedded, *items;
+	int count = 0;
+
+	if (error || code >= 300 || !json){
+		if (error)
+			snprintf(buf, sizeof(buf), "cYandexDisk: %s", error);
+		else
+			_c_yd_json_message(json, code, buf, sizeof(buf));
+		if (ctx->callback)
+			ctx->callback(NULL, ctx->user_data, buf);
+		if (json)
+			cJSON_Delete(json);
+		free(ctx);
+		return;
+	}
+
+	_embedded = cJSON_GetObjectItem(json, "_embedded");
+	items = cJSON_GetObjectItem(_embedded ? _embedded : json, "items");
+	if (items && !ctx->info) {
+		cJSON *item;
+		cJSON_ArrayForEach(item, items){
+			c_yd_file_t file;
+			c_json_to_c_yd_file_t(item, &file);
+			count++;
+			if (ctx->callback && ctx->callback(&file, ctx->user_data, NULL))
+			{
+				// stopped by callback
+				cJSON_Delete(json);
+				free(ctx);
+				return;
+			}
+		}
+	} else {
+		// resource is file
+		c_yd_file_t file;
+		c_json_to_c_yd_file_t(json, &file);
+		if (ctx->callback)
+			ctx->callback(&file, ctx->user_data, NULL);
+		if (ctx->info){
+			cJSON_Delete(json);
+			free(ctx);
+			return;
+		}
+	}
+	cJSON_Delete(json);
+
+	if (count == req->client->config.ls_page_size){
+		// get next page
+		char limit[32], offset[32];
+		ctx->offset += count;
+		sprintf(limit, "limit=%d", count);
+		sprintf(offset, "offset=%d", ctx->offset);
+		if (_c_yd_engine_api(req->client, "GET", ctx->api_suffix, NULL, 0, ctx, 
+					_c_yd_ls_async_on_json, limit, offset, 
+					ctx->arg[0] ? ctx->arg : NULL, NULL) == 0)
+			return;
+		if (ctx->callback)
+			ctx->callback(NULL, ctx->user_data, "cYandexDisk: can't queue request");
+		free(ctx);
+		return;
+	}
+
+	// listing finished
+	if (ctx->callback)
+		ctx->callback(NULL, ctx->user_data, NULL);
+	free(ctx);
+}
+
+static int _c_yd_ls_async(
+		c_yd_client_t *client, const char *api_suffix, const char *arg, bool info,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	int ret;
+	char limit[32], offset[32];
+	char fields_arg[BUFSIZ];
+	struct _c_yd_ls_async *ctx = NEW(struct _c_yd_ls_async);
+	if (!ctx)
+		return -1;
+	snprintf(ctx->api_suffix, sizeof(ctx->api_suffix), "%s", api_suffix);
+	arg = _c_yd_fields_arg(client, NULL, arg, !info, fields_arg, sizeof(fields_arg));
+	if (arg)
+		snprintf(ctx->arg, sizeof(ctx->arg), "%s", arg);
+	ctx->info = info;
+	ctx->user_data = user_data;
+	ctx->callback = callback;
+
+	sprintf(limit, "limit=%d", client->config.ls_page_size);
+	sprintf(offset, "offset=%d", 0);
+	if (info)
+		ret = _c_yd_engine_api(client, "GET", api_suffix, NULL, 0, ctx, 
+				_c_yd_ls_async_on_json, arg, NULL);
+	else
+		ret = _c_yd_engine_api(client, "GET", api_suffix, NULL, 0, ctx, 
+				_c_yd_ls_async_on_json, limit, offset, arg, NULL);
+	if (ret)
+		free(ctx);
+	return ret;
+}
+
+int c_yd_client_file_info_async(c_yd_client_t *client, const char * path, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	char path_arg[BUFSIZ];
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_ls_async(client, "v1/disk/resources", path_arg, true, user_data, callback);
+}
+
+int c_yd_client_ls_async(c_yd_client_t *client, const char * path, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	char path_arg[BUFSIZ];
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	return _c_yd_ls_async(client, "v1/disk/resources", path_arg, false, user_data, callback);
+}
+
+int c_yd_client_ls_public_async(c_yd_client_t *client, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	return _c_yd_ls_async(client, "v1/disk/resources/public", NULL, false, user_data, callback);
+}
+
+int c_yd_client_public_ls_async(c_yd_client_t *client, const char * public_key, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	char public_key_arg[BUFSIZ];
+	_c_yd_query_arg(public_key_arg, sizeof(public_key_arg), "public_key", public_key);	
+	return _c_yd_ls_async(client, "v1/disk/public/resources", public_key_arg, false, user_data, callback);
+}
+
+int c_yd_client_trash_ls_async(c_yd_client_t *client, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	return _c_yd_ls_async(client, "v1/disk/trash/resources", NULL, false, user_data, callback);
+}
+
+/* directory listing with page prefetch - first page gives
+ * number of items in directory, other pages are requested 
+ * at once with engine and passed to callback in caller 
+ * thread */
+struct _c_yd_ls_page {
+	struct _c_yd_ls_prefetch *ls;
+	char  *body;   //answer
+	size_t len;
+	long   code;
+	char  *error;
+	bool   done;
+	struct _c_yd_ls_page *next; //ready pages for unordered listing
+};
+
+struct _c_yd_ls_prefetch {
+	pthread_mutex_t lock;
+	pthread_cond_t  cond;      //signaled when page finished
+	int             pending;   //requests in engine
+	struct _c_yd_ls_page *ready;
+	struct _c_yd_ls_page *tail;
+	bool            unordered;
+};
+
+/* listing callback - c_yd_file_t or c_yd_entry_t records */
+struct _c_yd_ls_sink {
+	void *user_data;
+	int(*callback)(const c_yd_file_t *file, void * user_data, const char * error);
+	int(*entry_callback)(const c_yd_entry_t *entry, void * user_data, const char * error);
+	struct arena arena;  //strings of entries of page
+};
+
+/* set member of resource - strings are copied to arena */
+static void _c_yd_entry_set(
+		c_yd_entry_t *entry, struct arena *arena, 
+		const char *key, jstream_event_t event, const char *value)
+{
+	const char **dst = NULL;
+	enum _c_yd_field field = _c_yd_field(key);
+
+	if (event == JSTREAM_NUMBER){
+		if (field == YD_FIELD_SIZE)
+			entry->size = (c_yd_int64_t)strtod(value, NULL);
+		return;
+	}
+	if (event != JSTREAM_STRING)
+		return;
+
+	switch (field) {
+		case YD_FIELD_NAME:       dst = &entry->name;       break;
+		case YD_FIELD_TYPE:       dst = &entry->type;       break;
+		case YD_FIELD_PATH:       dst = &entry->path;       break;
+		case YD_FIELD_MIME_TYPE:  dst = &entry->mime_type;  break;
+		case YD_FIELD_PREVIEW:    dst = &entry->preview;    break;
+		case YD_FIELD_PUBLIC_KEY: dst = &entry->public_key; break;
+		case YD_FIELD_PUBLIC_URL: dst = &entry->public_url; break;
+		case YD_FIELD_MD5:        dst = &entry->md5;        break;
+		case YD_FIELD_SHA256:     dst = &entry->sha256;     break;
+		case YD_FIELD_CREATED:
+			entry->created = _c_yd_time(value);             break;
+		case YD_FIELD_MODIFIED:
+			entry->modified = _c_yd_time(value);            break;
+		default:
+			break;
+	}
+
+	if (dst){
+		char *str = arena_strdup(arena, value);
+		if (str)
+			*dst = str;
+	}
+}
+
+static void _c_yd_entry_clear(c_yd_entry_t *entry)
+{
+	entry->name = entry->type = entry->path = entry->mime_type = 
+		entry->preview = entry->public_key = entry->public_url = 
+		entry->md5 = entry->sha256 = "";
+	entry->size = entry->created = entry->modified = 0;
+}
+
+static void _c_yd_entry_to_file(const c_yd_entry_t *entry, c_yd_file_t *file)
+{
+	snprintf(file->name, sizeof(file->name), "%s", entry->name);
+	snprintf(file->type, sizeof(file->type), "%s", entry->type);
+	snprintf(file->path, sizeof(file->path), "%s", entry->path);
+	snprintf(file->mime_type, sizeof(file->mime_type), "%s", entry->mime_type);
+	snprintf(file->preview, sizeof(file->preview), "%s", entry->preview);
+	snprintf(file->public_key, sizeof(file->public_key), "%s", entry->public_key);
+	snprintf(file->public_url, sizeof(file->public_url), "%s", entry->public_url);
+	snprintf(file->md5, sizeof(file->md5), "%s", entry->md5);
+	snprintf(file->sha256, sizeof(file->sha256), "%s", entry->sha256);
+	file->size = (size_t)entry->size;
+	file->created = (time_t)entry->created;
+	file->modified = (time_t)entry->modified;
+}
+
+static void _c_yd_ls_error(struct _c_yd_ls_sink *sink, const char *error)
+{
+	if (sink->entry_callback)
+		sink->entry_callback(NULL, sink->user_data, error);
+	else if (sink->callback)
+		sink->callback(NULL, sink->user_data, error);
+}
+
+static void _c_yd_ls_item(struct _c_yd_ls_sink *sink, const c_yd_entry_t *entry)
+{
+	if (sink->entry_callback)
+		sink->entry_callback(entry, sink->user_data, NULL);
+	else if (sink->callback){
+		c_yd_file_t file;
+		_c_yd_entry_to_file(entry, &file);
+		sink->callback(&file, sink->user_data, NULL);
+	}
+}
+
+/* listing page parsed while it is received - item is passed 
+ * to sink when its object is closed, no JSON tree is built */
+struct _c_yd_ls_stream {
+	struct _c_yd_ls_sink *sink;
+	jstream_t    js;
+	int          depth;
+	int          items;      //depth of items array
+	int          item;       //depth of item object
+	char         keys[5][32];//last keys of first levels
+	c_yd_entry_t entry;      //parsed item
+	c_yd_entry_t resource;   //resource of page
+	bool         has_items;  //resource is directory
+	bool         failed;     //syntax error
+	bool         error;      //API error answer
+	char         message[256];
+	int          count;
+	int          total;
+};
+
+static const char *_c_yd_ls_stream_key(struct _c_yd_ls_stream *st, int depth)
+{
+	return depth < 5 ? st->keys[depth] : "";
+}
+
+static int _c_yd_ls_stream_token(
+		void *user_data, jstream_event_t event, const char *value, size_t len)
+{
+	struct _c_yd_ls_stream *st = user_data;
+	const char *key = _c_yd_ls_stream_key(st, st->depth);
+
+	switch (event) {
+		case JSTREAM_OBJECT_BEGIN:
+		case JSTREAM_ARRAY_BEGIN:
+			st->depth++;
+			if (st->depth < 5)
+				st->keys[st->depth][0] = 0;
+			if (event == JSTREAM_OBJECT_BEGIN){
+				if (st->items && st->depth == st->items + 1){
+					st->item = st->depth;
+					_c_yd_entry_clear(&st->entry);
+				}
+			} else if (!st->items && (
+				// _embedded.items of directory or items of list
+				(st->depth == 3 && !strcmp(st->keys[1], "_embedded") && 
+				 !strcmp(st->keys[2], "items")) ||
+				(st->depth == 2 && !strcmp(st->keys[1], "items"))))
+			{
+				st->items = st->depth;
+				st->has_items = true;
+			}
+			break;
+		
+		case JSTREAM_OBJECT_END:
+			if (st->item && st->depth == st->item){
+				st->item = 0;
+				st->count++;
+				_c_yd_ls_item(st->sink, &st->entry);
+			}
+			st->depth--;
+			break;
+		
+		case JSTREAM_ARRAY_END:
+			if (st->depth == st->items)
+				st->items = 0;
+			st->depth--;
+			break;
+
+		case JSTREAM_KEY:
+			if (st->depth < 5)
+				snprintf(st->keys[st->depth], sizeof(st->keys[0]), 
+						"%.*s", (int)len, value);
+			break;
+
+		default:
+			if (st->item && st->depth == st->item)
+				_c_yd_entry_set(&st->entry, &st->sink->arena, key, event, value);
+			else if (st->depth == 1){
+				_c_yd_entry_set(&st->resource, &st->sink->arena, key, event, value);
+				if (!strcmp(key, "error"))
+					st->error = true;
+				else if (!strcmp(key, "message") && event == JSTREAM_STRING)
+					snprintf(st->message, sizeof(st->message), 
+							"%.*s", (int)len, value);
+			} else if (st->depth == 2 && event == JSTREAM_NUMBER &&
+					!strcmp(st->keys[1], "_embedded") && !strcmp(key, "total"))
+				st->total = atoi(value);
+			break;
+	}
+	return 0;
+}
+
+static void _c_yd_ls_stream_init(
+		struct _c_yd_ls_stream *st, struct _c_yd_ls_sink *sink)
+{
+	memset(st, 0, sizeof(struct _c_yd_ls_stream));
+	st->sink = sink;
+	st->total = -1;
+	_c_yd_entry_clear(&st->resource);
+	jstream_init(&st->js, st, _c_yd_ls_stream_token);
+}
+
+static void _c_yd_ls_stream_feed(
+		struct _c_yd_ls_stream *st, const char *data, size_t len)
+{
+	if (!st->failed && jstream_feed(&st->js, data, len))
+		st->failed = true;
+}
+
+/* end of page - return number of items or -1 on error, total
+ * is number of items in directory (-1 if unknown) */
+static int _c_yd_ls_stream_end(
+		struct _c_yd_ls_stream *st, long code, const char *error, int *total)
+{
+	char buf[BUFSIZ];
+	
+	if (!error && !st->failed && jstream_finish(&st->js))
+		st->failed = true;
+	jstream_free(&st->js);
+	
+	*total = -1;
+	if (error || st->failed || st->error || code >= 300){
+		if (error)
+			snprintf(buf, sizeof(buf), "%s", error);
+		else if (st->message[0])
+			snprintf(buf, sizeof(buf), "cYandexDisk: %s", st->message);
+		else if (code >= 300)
+			snprintf(buf, sizeof(buf), "cYandexDisk: HTTP error: %ld", code);
+		else
+			snprintf(buf, sizeof(buf), "cYandexDisk: can't parse answer");
+		_c_yd_ls_error(st->sink, buf);
+		return -1;
+	}
+
+	if (!st->has_items){
+		// resource is file
+		_c_yd_ls_item(st->sink, &st->resource);
+		return 0;
+	}
+	*total = st->total;
+	return st->count;
+}
+
+static size_t _c_yd_ls_writefunc(
+		void *data, size_t size, size_t nmemb, void *user_data)
+{
+	struct _c_yd_ls_stream *st = user_data;
+	_c_yd_ls_stream_feed(st, data, size * nmemb);
+	// stop transfer on syntax error
+	return st->failed ? 0 : size * nmemb;
+}
+
+static void _c_yd_api_url_args(
+		char *url, size_t size, const char *api_suffix, ...)
+{
+	va_list argv;
+	va_start(argv, api_suffix);
+	_c_yd_api_url(url, size, api_suffix, argv);
+	va_end(argv);
+}
+
+/* get page of listing - items are passed to sink while 
+ * answer is received */
+static int _c_yd_ls_get(
+		c_yd_client_t *client, const char *api_suffix, 
+		const char *limit, const char *offset, const char *arg,
+		struct _c_yd_ls_sink *sink, int *total)
+{
+	struct _c_yd_ls_stream st;
+	char url[BUFSIZ], error[64];
+	CURLcode res;
+	long code = 0;
+	CURL *curl = _c_yd_pool_get(&client->pool);
+	
+	if (!curl){
+		*total = -1;
+		_c_yd_ls_error(sink, "cYandexDisk: can't init curl");
+		return -1;
+	}
+	
+	_c_yd_api_url_args(url, sizeof(url), api_suffix, limit, offset, arg, NULL);
+	_c_yd_ls_stream_init(&st, sink);
+
+	curl_easy_setopt(curl, CURLOPT_URL, url);
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);		
+	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, client->header);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _c_yd_ls_writefunc);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &st);
+	_c_yd_client_setopt(client, curl);
+
+	res = curl_easy_perform(curl);
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+	_c_yd_pool_put(&client->pool, curl);
+	
+	if (res != CURLE_OK && !st.failed)
+		snprintf(error, sizeof(error), 
+				"cYandexDisk: curl returned error: %d", res);
+	return _c_yd_ls_stream_end(&st, code, 
+			res != CURLE_OK && !st.failed ? error : NULL, total);
+}
+
+/* page finished - takes answer and allocated error */
+static void _c_yd_ls_page_done(
+		struct _c_yd_ls_page *page, char *body, size_t len, long code, char *error)
+{
+	struct _c_yd_ls_prefetch *ls = page->ls;
+
+	pthread_mutex_lock(&ls->lock);
+	page->body = body;
+	page->len = len;
+	page->code = code;
+	page->error = error;
+	page->done = true;
+	if (ls->unordered){
+		if (ls->tail)
+			ls->tail->next = page;
+		else
+			ls->ready = page;
+		ls->tail = page;
+	}
+	ls->pending--;
+	pthread_cond_broadcast(&ls->cond);
+	pthread_mutex_unlock(&ls->lock);
+}
+
+static void _c_yd_ls_page_on_done(
+		struct _c_yd_request *req, CURL *curl, CURLcode res)
+{
+	char error[64];
+	long code = 0;
+
+	if (res != CURLE_OK){
+		snprintf(error, sizeof(error), 
+				"cYandexDisk: curl returned error: %d", res);
+		_c_yd_ls_page_done(req->data, NULL, 0, 0, strdup(error));
+		return;
+	}
+	
+	// take answer - it is parsed in caller thread
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+	_c_yd_ls_page_done(req->data, req->s.str, req->s.len, code, NULL);
+	req->s.str = NULL;
+}
+
+/* true if called from driver thread of client engine */
+static bool _c_yd_in_engine(c_yd_client_t *client)
+{
+	struct _c_yd_engine *engine;
+	
+	pthread_mutex_lock(&client->lock);
+	engine = client->engine;
+	pthread_mutex_unlock(&client->lock);
+	
+	return engine && pthread_equal(pthread_self(), engine->thread);
+}
+
+/* get pages from offset with prefetch - return number of 
+ * items in last page or -1 on error; pages after page that
+ * is not full are not asked */
+static int _c_yd_ls_prefetch(
+		c_yd_client_t *client, const char *api_suffix, const char *arg,
+		int offset, int npages, struct _c_yd_ls_sink *sink)
+{
+	struct _c_yd_ls_prefetch ls;
+	struct _c_yd_ls_page *pages, *page;
+	int next = 0, delivered = 0, last = 0, total, count;
+	int stop = npages;  //pages to ask
+	int window = client->config.ls_prefetch;
+	int l = client->config.ls_page_size;
+	char limit[32];
+	bool failed = false;
+
+	pages = calloc(npages, sizeof(struct _c_yd_ls_page));
+	if (!pages){
+		_c_yd_ls_error(sink, "cYandexDisk: can't allocate memory");
+		return -1;
+	}
+	memset(&ls, 0, sizeof(ls));
+	pthread_mutex_init(&ls.lock, NULL);
+	pthread_cond_init(&ls.cond, NULL);
+	ls.unordered = client->config.ls_unordered;
+	sprintf(limit, "limit=%d", l);
+
+	pthread_mutex_lock(&ls.lock);
+	while (delivered < (next > stop ? next : stop) && !failed) {
+		// keep window of pages in flight
+		while (next < stop && next - delivered < window) {
+			char offset_arg[32];
+			page = &pages[next];
+			page->ls = &ls;
+			sprintf(offset_arg, "offset=%d", offset + next++ * l);
+			ls.pending++;
+			pthread_mutex_unlock(&ls.lock);
+			if (_c_yd_engine_get(client, api_suffix, page, 
+						_c_yd_ls_page_on_done, limit, offset_arg, arg, NULL))
+				_c_yd_ls_page_done(page, NULL, 0, 0, 
+						strdup("cYandexDisk: can't queue request"));
+			pthread_mutex_lock(&ls.lock);
+		}
+		
+		// wait for next page
+		if (ls.unordered){
+			while (!ls.ready)
+				pthread_cond_wait(&ls.cond, &ls.lock);
+			page = ls.ready;
+			ls.ready = page->next;
+			if (!ls.ready)
+				ls.tail = NULL;
+		} else {
+			page = &pages[delivered];
+			while (!page->done)
+				pthread_cond_wait(&ls.cond, &ls.lock);
+		}
+		pthread_mutex_unlock(&ls.lock);
+
+		{
+			struct _c_yd_ls_stream st;
+			// entries of previous page are not used any more
+			arena_reset(&sink->arena);
+			_c_yd_ls_stream_init(&st, sink);
+			if (page->body)
+				_c_yd_ls_stream_feed(&st, page->body, page->len);
+			count = _c_yd_ls_stream_end(&st, page->code, page->error, &total);
+		}
+		if (count < 0)
+			failed = true;
+		else if (count < l && page - pages < stop)
+			stop = page - pages + 1; //end of listing
+		if (page - pages == stop - 1)
+			last = count;
+		free(page->body);
+		page->body = NULL;
+		free(page->error);
+		page->error = NULL;
+		
+		pthread_mutex_lock(&ls.lock);
+		delivered++;
+	}
+
+	// wait for pages still in engine
+	while (ls.pending > 0)
+		pthread_cond_wait(&ls.cond, &ls.lock);
+	pthread_mutex_unlock(&ls.lock);
+
+	for (page = pages; page < pages + next; ++page) {
+		free(page->body);
+		free(page->error);
+	}
+	free(pages);
+	pthread_mutex_destroy(&ls.lock);
+	pthread_cond_destroy(&ls.cond);
+	
+	return failed ? -1 : last;
+}
+
+static int _c_yd_ls_pages(
+		c_yd_client_t *client, const char *api_suffix, const char *arg,
+		const char *fields, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error),
+		int(*entry_callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
+{
+	int offset = 0, count, total;
+	int l = client->config.ls_page_size;
+	char limit[32], offset_arg[32], fields_arg[BUFSIZ];
+	struct _c_yd_ls_sink sink;
+
+	sink.user_data = user_data;
+	sink.callback = callback;
+	sink.entry_callback = entry_callback;
+	arena_init(&sink.arena, 0);
+
+	sprintf(limit, "limit=%d", l);
+	arg = _c_yd_fields_arg(client, fields, arg, true, fields_arg, sizeof(fields_arg));
+	
+	for (;;) {
+		sprintf(offset_arg, "offset=%d", offset);
+		arena_reset(&sink.arena);
+		count = _c_yd_ls_get(client, api_suffix, limit, offset_arg, arg, 
+				&sink, &total);
+		if (count < l)
+			break;
+		offset += l;
+
+		// total from first page - get other pages at once, 
+		// without total (flat list) window of pages is asked 
+		// ahead (not from engine callback - it would wait for 
+		// itself)
+		if ((total > offset || total < 0) && 
+				client->config.ls_prefetch > 1 && 
+				!_c_yd_in_engine(client))
+		{
+			do {
+				int npages = total < 0 ? 4 * client->config.ls_prefetch :
+					(total - offset + l - 1) / l;
+				count = _c_yd_ls_prefetch(client, api_suffix, arg, 
+						offset, npages, &sink);
+				offset += npages * l;
+			} while (count == l && total < 0);
+			if (count < l)
+				break;
+			// directory grew while listing
+		}
+	}
+
+	arena_free(&sink.arena);
+	return count < 0 ? -1 : 0;
+}
+
+/* directory listing through cache - items are passed to
+ * callback while they are copied for cache and index */
+struct _c_yd_cache_fill {
+	struct _c_yd_ls_sink sink;    //callback of caller
+	c_yd_entry_t        *entries;
+	int                  count;
+	int                  size;
+	bool                 failed;  //listing is not cached
+};
+
+static int _c_yd_cache_fill_item(
+		const c_yd_entry_t *entry, void *user_data, const char *error)
+{
+	struct _c_yd_cache_fill *fill = user_data;
+	char *strings;
+
+	if (error){
+		fill->failed = true;
+		_c_yd_ls_error(&fill->sink, error);
+		return 0;
+	}
+	
+	if (!fill->failed && fill->count == fill->size){
+		int size = fill->size ? fill->size * 2 : 64;
+		c_yd_entry_t *entries = 
+			realloc(fill->entries, size * sizeof(c_yd_entry_t));
+		if (entries){
+			fill->entries = entries;
+			fill->size = size;
+		} else
+			fill->failed = true;
+	}
+	if (!fill->failed){
+		strings = arena_alloc(&fill->sink.arena, _c_yd_entry_strings_size(entry));
+		if (strings){
+			fill->entries[fill->count] = *entry;
+			_c_yd_entry_strings_copy(&fill->entries[fill->count++], strings);
+		} else
+			fill->failed = true;
+	}
+	
+	_c_yd_ls_item(&fill->sink, entry);
+	return 0;
+}
+
+static int _c_yd_cache_ls(c_yd_client_t *client, const char *path, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error), int(*entry_callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
+{
+	struct _c_yd_cache_fill fill;
+	struct _c_yd_cache_item *item;
+	unsigned long generation = 0;
+	char path_arg[BUFSIZ];
+	int i, ret;
+	
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);	
+	if (!client->cache && !client->index)
+		return _c_yd_ls_pages(client, "v1/disk/resources", path_arg, NULL, user_data, callback, entry_callback);
+
+	memset(&fill, 0, sizeof(fill));
+	fill.sink.user_data = user_data;
+	fill.sink.callback = callback;
+	fill.sink.entry_callback = entry_callback;
+	
+	item = _c_yd_cache_get(client, YD_CACHE_LS, path, &generation);
+	if (item){
+		for (i = 0; i < item->count; ++i)
+			_c_yd_ls_item(&fill.sink, &item->entries[i]);
+		_c_yd_cache_release(client->cache, item);
+		return 0;
+	}
+
+	arena_init(&fill.sink.arena, 0);
+	ret = _c_yd_ls_pages(client, "v1/disk/resources", path_arg, NULL, &fill, NULL, _c_yd_cache_fill_item);
+	if (ret == 0 && !fill.failed){
+		_c_yd_cache_put(client, YD_CACHE_LS, path, fill.entries, fill.count, generation);
+		_c_yd_index_put(client, path, fill.entries, fill.count);
+	}
+	free(fill.entries);
+	arena_free(&fill.sink.arena);
+	return ret;
+}
+
+int c_yd_client_ls_entries(c_yd_client_t *client, const char * path, void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
+{
+	return _c_yd_cache_ls(client, path, user_data, NULL, callback);
+}
+
+int c_yd_client_public_ls_entries(c_yd_client_t *client, const char * public_key, void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
+{
+	char public_key_arg[BUFSIZ];
+	
+	_c_yd_query_arg(public_key_arg, sizeof(public_key_arg), "public_key", public_key);	
+	return _c_yd_ls_pages(client, "v1/disk/public/resources", public_key_arg, NULL, user_data, NULL, callback);
+}
+
+int c_yd_client_trash_ls_entries(c_yd_client_t *client, void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
+{
+	return _c_yd_ls_pages(client, "v1/disk/trash/resources", NULL, NULL, user_data, NULL, callback);
+}
+
+/* flat listing of files - items are added to index */
+struct _c_yd_files {
+	struct _c_yd_ls_sink sink;    //callback of caller
+	c_yd_client_t       *client;
+};
+
+static int _c_yd_files_item(
+		const c_yd_entry_t *entry, void *user_data, const char *error)
+{
+	struct _c_yd_files *files = user_data;
+	
+	if (error){
+		_c_yd_ls_error(&files->sink, error);
+		return 0;
+	}
+	_c_yd_index_put(files->client, NULL, entry, 1);
+	_c_yd_ls_item(&files->sink, entry);
+	return 0;
+}
+
+static int _c_yd_files(c_yd_client_t *client, const char *media_type, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error), int(*entry_callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
+{
+	struct _c_yd_files files;
+	char media_type_arg[BUFSIZ];
+	
+	if (media_type)
+		_c_yd_query_arg(media_type_arg, sizeof(media_type_arg), "media_type", media_type);	
+	if (!client->index)
+		return _c_yd_ls_pages(client, "v1/disk/resources/files", 
+				media_type ? media_type_arg : NULL, NULL, user_data, callback, entry_callback);
+	
+	memset(&files, 0, sizeof(files));
+	files.sink.user_data = user_data;
+	files.sink.callback = callback;
+	files.sink.entry_callback = entry_callback;
+	files.client = client;
+	return _c_yd_ls_pages(client, "v1/disk/resources/files", 
+			media_type ? media_type_arg : NULL, NULL, &files, NULL, _c_yd_files_item);
+}
+
+int c_yd_client_files(c_yd_client_t *client, const char * media_type, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	return _c_yd_files(client, media_type, user_data, callback, NULL);
+}
+
+int c_yd_client_files_entries(c_yd_client_t *client, const char * media_type, void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
+{
+	return _c_yd_files(client, media_type, user_data, NULL, callback);
+}
+
+c_yd_entry_t *c_yd_entry_dup(const c_yd_entry_t *entry)
+{
+	c_yd_entry_t *copy;
+
+	if (!entry)
+		return NULL;
+	
+	// one allocation for entry and strings
+	copy = malloc(sizeof(c_yd_entry_t) + _c_yd_entry_strings_size(entry));
+	if (!copy)
+		return NULL;
+	
+	*copy = *entry;
+	_c_yd_entry_strings_copy(copy, (char *)(copy + 1));
+	return copy;
+}
+
+/* walk of directory tree - directories are listed breadth-
+ * first, pages of many directories are in engine at once
+ * and parsed in caller thread */
+struct _c_yd_walk;
+
+struct _c_yd_walk_dir {
+	struct _c_yd_walk    *walk;
+	struct _c_yd_ls_sink  sink;    //strings of items are in sink arena
+	char                 *path;
+	char                 *arg;     //path and fields arguments
+	int                   depth;   //depth of items
+	int                   pages;   //unfinished pages
+	int                   end;     //offset after planned pages
+	c_yd_entry_t         *entries; //items for dir_callback and index
+	int                   count;
+	int                   size;
+	char                 *error;   //listing error
+	struct _c_yd_walk_dir *next;   //queue of directories
+};
+
+struct _c_yd_walk_page {
+	struct _c_yd_ls_page   page;   //answer - first member
+	struct _c_yd_walk_dir *dir;
+	int                    offset;
+	struct _c_yd_walk_page *next;  //queue of pages
+};
+
+struct _c_yd_walk {
+	c_yd_client_t            *client;
+	const c_yd_walk_config_t *config;
+	struct _c_yd_ls_prefetch  ls;     //finished pages
+	char                      limit[32];
+	char                      fields[BUFSIZ];
+	struct _c_yd_walk_dir    *dirs;   //directories to list
+	struct _c_yd_walk_dir    *dirs_tail;
+	struct _c_yd_walk_page   *queue;  //pages to request
+	struct _c_yd_walk_page   *queue_tail;
+	bool                      stopped;
+	bool                      failed;
+};
+
+void c_yd_walk_config_init(c_yd_walk_config_t *config)
+{
+	memset(config, 0, sizeof(c_yd_walk_config_t));
+	config->concurrency = YD_WALK_CONCURRENCY;
+	config->page_size = YD_WALK_PAGE_SIZE;
+}
+
+static void _c_yd_walk_dir_free(struct _c_yd_walk_dir *dir)
+{
+	arena_free(&dir->sink.arena);
+	free(dir->entries);
+	free(dir->error);
+	free(dir->arg);
+	free(dir->path);
+	free(dir);
+}
+
+static int _c_yd_walk_item(
+		const c_yd_entry_t *entry, void *user_data, const char *error);
+
+/* add directory to queue */
+static int _c_yd_walk_dir_new(
+		struct _c_yd_walk *walk, const char *path, int depth)
+{
+	char path_arg[BUFSIZ];
+	struct _c_yd_walk_dir *dir = NEW(struct _c_yd_walk_dir);
+	if (!dir)
+		return -1;
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+
+	dir->walk = walk;
+	dir->depth = depth;
+	dir->sink.user_data = dir;
+	dir->sink.entry_callback = _c_yd_walk_item;
+	arena_init(&dir->sink.arena, 0);
+	dir->path = strdup(path);
+	dir->arg = malloc(strlen(path_arg) + strlen(walk->fields) + 2);
+	if (!dir->path || !dir->arg){
+		_c_yd_walk_dir_free(dir);
+		return -1;
+	}
+	sprintf(dir->arg, "%s%s%s", path_arg, 
+			walk->fields[0] ? "&" : "", walk->fields);
+
+	if (walk->dirs_tail)
+		walk->dirs_tail->next = dir;
+	else
+		walk->dirs = dir;
+	walk->dirs_tail = dir;
+	return 0;
+}
+
+/* queue next page of directory */
+static int _c_yd_walk_plan(
+		struct _c_yd_walk *walk, struct _c_yd_walk_dir *dir)
+{
+	struct _c_yd_walk_page *page = NEW(struct _c_yd_walk_page);
+	if (!page)
+		return -1;
+	page->page.ls = &walk->ls;
+	page->dir = dir;
+	page->offset = dir->end;
+	dir->end += walk->config->page_size;
+	dir->pages++;
+
+	if (walk->queue_tail)
+		walk->queue_tail->next = page;
+	else
+		walk->queue = page;
+	walk->queue_tail = page;
+	return 0;
+}
+
+/* next page to request - pages of started directories first */
+static struct _c_yd_walk_page *_c_yd_walk_next(struct _c_yd_walk *walk)
+{
+	struct _c_yd_walk_page *page;
+
+	if (!walk->queue && walk->dirs){
+		struct _c_yd_walk_dir *dir = walk->dirs;
+		walk->dirs = dir->next;
+		if (!walk->dirs)
+			walk->dirs_tail = NULL;
+		if (_c_yd_walk_plan(walk, dir)){
+			_c_yd_walk_dir_free(dir);
+			walk->failed = true;
+			return NULL;
+		}
+	}
+	
+	page = walk->queue;
+	if (page){
+		walk->queue = page->next;
+		if (!walk->queue)
+			walk->queue_tail = NULL;
+	}
+	return page;
+}
+
+/* item of directory - called while page is parsed */
+static int _c_yd_walk_item(
+		const c_yd_entry_t *entry, void *user_data, const char *error)
+{
+	struct _c_yd_walk_dir *dir = user_data;
+	struct _c_yd_walk *walk = dir->walk;
+	const c_yd_walk_config_t *config = walk->config;
+	int ret = 0;
+
+	if (walk->stopped || walk->failed)
+		return -1;
+
+	if (error){
+		if (!dir->error)
+			dir->error = strdup(error);
+		if (config->callback && 
+				config->callback(NULL, dir->depth, config->user_data, error) < 0)
+			walk->stopped = true;
+		return 0;
+	}
+
+	if (config->callback){
+		ret = config->callback(entry, dir->depth, config->user_data, NULL);
+		if (ret < 0){
+			walk->stopped = true;
+			return -1;
+		}
+	}
+
+	if (config->dir_callback || walk->client->index){
+		if (dir->count == dir->size){
+			int size = dir->size ? dir->size * 2 : 64;
+			c_yd_entry_t *entries = 
+				realloc(dir->entries, size * sizeof(c_yd_entry_t));
+			if (!entries){
+				walk->failed = true;
+				return -1;
+			}
+			dir->entries = entries;
+			dir->size = size;
+		}
+		dir->entries[dir->count++] = *entry;
+	}
+
+	if (ret != C_YD_WALK_PRUNE && strcmp(entry->type, "dir") == 0 &&
+			(config->max_depth < 1 || dir->depth < config->max_depth))
+	{
+		if (_c_yd_walk_dir_new(walk, entry->path, dir->depth + 1))
+			walk->failed = true;
+	}
+	return 0;
+}
+
+/* parse page and plan next pages of directory */
+static void _c_yd_walk_page(
+		struct _c_yd_walk *walk, struct _c_yd_walk_page *page)
+{
+	struct _c_yd_walk_dir *dir = page->dir;
+	const c_yd_walk_config_t *config = walk->config;
+	int l = config->page_size, count, total;
+	
+	// strings of items are kept for dir_callback and index only
+	if (!config->dir_callback && !walk->client->index)
+		arena_reset(&dir->sink.arena);
+	
+	if (page->page.done){
+		struct _c_yd_ls_stream st;
+		_c_yd_ls_stream_init(&st, &dir->sink);
+		if (page->page.body)
+			_c_yd_ls_stream_feed(&st, page->page.body, page->page.len);
+		count = _c_yd_ls_stream_end(&st, page->page.code, 
+				page->page.error, &total);
+	} else {
+		// called from engine thread - get page here
+		char offset_arg[32];
+		sprintf(offset_arg, "offset=%d", page->offset);
+		count = _c_yd_ls_get(walk->client, "v1/disk/resources", 
+				walk->limit, offset_arg, dir->arg, &dir->sink, &total);
+	}
+	dir->pages--;
+
+	// last planned page is full - plan pages up to total 
+	// from answer or one more page
+	if (count == l && page->offset + l == dir->end && 
+			!walk->stopped && !walk->failed)
+	{
+		do {
+			if (_c_yd_walk_plan(walk, dir)){
+				walk->failed = true;
+				break;
+			}
+		} while (dir->end < total);
+	}
+	
+	free(page->page.body);
+	free(page->page.error);
+	free(page);
+
+	if (dir->pages)
+		return;
+
+	// directory is listed
+	if (!dir->error && !walk->stopped && !walk->failed)
+		_c_yd_index_put(walk->client, dir->path, dir->entries, dir->count);
+	if (config->dir_callback && !walk->stopped && !walk->failed &&
+			config->dir_callback(dir->path, dir->entries, dir->count, 
+				dir->depth, config->user_data, dir->error) < 0)
+		walk->stopped = true;
+	_c_yd_walk_dir_free(dir);
+}
+
+int c_yd_client_walk(c_yd_client_t *client, const char *path, const c_yd_walk_config_t *_config)
+{
+	struct _c_yd_walk walk;
+	struct _c_yd_walk_page *page;
+	struct _c_yd_walk_dir *dir;
+	c_yd_walk_config_t config;
+	const char *fields;
+	bool in_engine = _c_yd_in_engine(client);
+
+	if (_config)
+		config = *_config;
+	else
+		c_yd_walk_config_init(&config);
+	if (config.concurrency < 1)
+		config.concurrency = YD_WALK_CONCURRENCY;
+	if (config.page_size < 1)
+		config.page_size = YD_WALK_PAGE_SIZE;
+
+	memset(&walk, 0, sizeof(walk));
+	walk.client = client;
+	walk.config = &config;
+	pthread_mutex_init(&walk.ls.lock, NULL);
+	pthread_cond_init(&walk.ls.cond, NULL);
+	walk.ls.unordered = true;
+	sprintf(walk.limit, "limit=%d", config.page_size);
+	
+	// walk needs type and path of items
+	fields = _c_yd_fields_arg(client, NULL, NULL, true, walk.fields, sizeof(walk.fields));
+	if (fields){
+		size_t len = strlen(walk.fields);
+		snprintf(walk.fields + len, sizeof(walk.fields) - len, 
+				",_embedded.items.type,_embedded.items.path");
+	} else
+		walk.fields[0] = 0;
+
+	if (_c_yd_walk_dir_new(&walk, path, 1)){
+		if (config.callback)
+			config.callback(NULL, 1, config.user_data, "cYandexDisk: can't allocate memory");
+		return -1;
+	}
+
+	pthread_mutex_lock(&walk.ls.lock);
+	for (;;) {
+		// keep window of pages in flight
+		while (!walk.stopped && !walk.failed && 
+				walk.ls.pending < config.concurrency && 
+				(page = _c_yd_walk_next(&walk)))
+		{
+			char offset_arg[32];
+			if (in_engine){
+				// engine would wait for itself - one page at once
+				pthread_mutex_unlock(&walk.ls.lock);
+				_c_yd_walk_page(&walk, page);
+				pthread_mutex_lock(&walk.ls.lock);
+				continue;
+			}
+			sprintf(offset_arg, "offset=%d", page->offset);
+			walk.ls.pending++;
+			pthread_mutex_unlock(&walk.ls.lock);
+			if (_c_yd_engine_get(client, "v1/disk/resources", &page->page, 
+						_c_yd_ls_page_on_done, walk.limit, offset_arg, 
+						page->dir->arg, NULL))
+				_c_yd_ls_page_done(&page->page, NULL, 0, 0, 
+						strdup("cYandexDisk: can't queue request"));
+			pthread_mutex_lock(&walk.ls.lock);
+		}
+		
+		if (!walk.ls.pending && !walk.ls.ready)
+			break;
+		
+		// parse finished page
+		while (!walk.ls.ready)
+			pthread_cond_wait(&walk.ls.cond, &walk.ls.lock);
+		page = (struct _c_yd_walk_page *)walk.ls.ready;
+		walk.ls.ready = walk.ls.ready->next;
+		if (!walk.ls.ready)
+			walk.ls.tail = NULL;
+		pthread_mutex_unlock(&walk.ls.lock);
+		
+		_c_yd_walk_page(&walk, page);
+		
+		pthread_mutex_lock(&walk.ls.lock);
+	}
+	pthread_mutex_unlock(&walk.ls.lock);
+
+	// walk stopped - release pages and directories not listed
+	while ((page = walk.queue)) {
+		walk.queue = page->next;
+		dir = page->dir;
+		free(page);
+		if (--dir->pages == 0)
+			_c_yd_walk_dir_free(dir);
+	}
+	while ((dir = walk.dirs)) {
+		walk.dirs = dir->next;
+		_c_yd_walk_dir_free(dir);
+	}
+	pthread_mutex_destroy(&walk.ls.lock);
+	pthread_cond_destroy(&walk.ls.cond);
+
+	return walk.stopped || walk.failed ? -1 : 0;
+}
+
+/* listing cursor - window of pages is in engine, pages are
+ * parsed in caller thread when caller takes their items */
+struct c_yd_cursor {
+	c_yd_client_t           *client;
+	char                     api_suffix[64];
+	char                     arg[BUFSIZ];    //path and fields
+	char                     limit[32];
+	int                      page_size;
+	int                      window;         //pages asked ahead
+	struct _c_yd_ls_prefetch ls;
+	struct _c_yd_ls_page    *pages;          //page n is in pages[n % window]
+	int                      next;           //pages asked
+	int                      delivered;      //pages parsed
+	int                      end;            //pages of listing
+	bool                     sync;           //opened in engine thread
+	struct _c_yd_ls_sink     sink;           //strings of page items
+	c_yd_entry_t            *entries;        //items of page
+	int                      count;
+	int                      size;
+	int                      pos;            //next item
+	char                    *error;
+};
+
+static int _c_yd_cursor_item(
+		const c_yd_entry_t *entry, void *user_data, const char *error)
+{
+	c_yd_cursor_t *cursor = user_data;
+
+	if (error){
+		if (!cursor->error)
+			cursor->error = strdup(error);
+		return 0;
+	}
+	if (cursor->count == cursor->size){
+		int size = cursor->size ? cursor->size * 2 : 64;
+		c_yd_entry_t *entries = 
+			realloc(cursor->entries, size * sizeof(c_yd_entry_t));
+		if (!entries){
+			if (!cursor->error)
+				cursor->error = strdup("cYandexDisk: can't allocate memory");
+			return -1;
+		}
+		cursor->entries = entries;
+		cursor->size = size;
+	}
+	cursor->entries[cursor->count++] = *entry;
+	return 0;
+}
+
+/* keep window of pages in flight - called with lock */
+static void _c_yd_cursor_plan(c_yd_cursor_t *cursor)
+{
+	while (!cursor->sync && cursor->next < cursor->end && 
+			cursor->next - cursor->delivered < cursor->window) 
+	{
+		struct _c_yd_ls_page *page = 
+			&cursor->pages[cursor->next % cursor->window];
+		char offset_arg[32];
+		
+		memset(page, 0, sizeof(struct _c_yd_ls_page));
+		page->ls = &cursor->ls;
+		sprintf(offset_arg, "offset=%d", cursor->next++ * cursor->page_size);
+		cursor->ls.pending++;
+		pthread_mutex_unlock(&cursor->ls.lock);
+		if (_c_yd_engine_get(cursor->client, cursor->api_suffix, page, 
+					_c_yd_ls_page_on_done, cursor->limit, offset_arg, 
+					cursor->arg[0] ? cursor->arg : NULL, NULL))
+			_c_yd_ls_page_done(page, NULL, 0, 0, 
+					strdup("cYandexDisk: can't queue request"));
+		pthread_mutex_lock(&cursor->ls.lock);
+	}
+}
+
+/* parse next page to items - return -1 on error */
+static int _c_yd_cursor_page(c_yd_cursor_t *cursor)
+{
+	int count, total;
+
+	cursor->count = cursor->pos = 0;
+	arena_reset(&cursor->sink.arena);
+	
+	if (cursor->sync){
+		// engine would wait for itself - one page at once
+		char offset_arg[32];
+		sprintf(offset_arg, "offset=%d", cursor->delivered * cursor->page_size);
+		count = _c_yd_ls_get(cursor->client, cursor->api_suffix, 
+				cursor->limit, offset_arg, cursor->arg[0] ? cursor->arg : NULL, 
+				&cursor->sink, &total);
+	} else {
+		struct _c_yd_ls_page *page = 
+			&cursor->pages[cursor->delivered % cursor->window];
+		struct _c_yd_ls_stream st;
+
+		pthread_mutex_lock(&cursor->ls.lock);
+		_c_yd_cursor_plan(cursor);
+		while (!page->done)
+			pthread_cond_wait(&cursor->ls.cond, &cursor->ls.lock);
+		pthread_mutex_unlock(&cursor->ls.lock);
+
+		_c_yd_ls_stream_init(&st, &cursor->sink);
+		if (page->body)
+			_c_yd_ls_stream_feed(&st, page->body, page->len);
+		count = _c_yd_ls_stream_end(&st, page->code, page->error, &total);
+		free(page->body);
+		page->body = NULL;
+		free(page->error);
+		page->error = NULL;
+	}
+	cursor->delivered++;
+	
+	if (count < 0 || cursor->error){
+		cursor->end = cursor->delivered;
+		return -1;
+	}
+	if (count < cursor->page_size)
+		cursor->end = cursor->delivered; //end of listing
+	else if (cursor->delivered == 1 && total >= 0)
+		// do not ask pages after total
+		cursor->end = (total + cursor->page_size - 1) / cursor->page_size;
+	if (count == cursor->page_size && cursor->end <= cursor->delivered)
+		cursor->end = cursor->delivered + 1; //directory grew
+	
+	// ask next pages while caller takes items
+	if (!cursor->sync){
+		pthread_mutex_lock(&cursor->ls.lock);
+		_c_yd_cursor_plan(cursor);
+		pthread_mutex_unlock(&cursor->ls.lock);
+	}
+	return 0;
+}
+
+void c_yd_cursor_close(c_yd_cursor_t *cursor)
+{
+	int i;
+
+	if (!cursor)
+		return;
+	if (!cursor->sync){
+		// wait for pages still in engine
+		pthread_mutex_lock(&cursor->ls.lock);
+		while (cursor->ls.pending > 0)
+			pthread_cond_wait(&cursor->ls.cond, &cursor->ls.lock);
+		pthread_mutex_unlock(&cursor->ls.lock);
+		for (i = 0; i < cursor->window; ++i) {
+			free(cursor->pages[i].body);
+			free(cursor->pages[i].error);
+		}
+	}
+	pthread_mutex_destroy(&cursor->ls.lock);
+	pthread_cond_destroy(&cursor->ls.cond);
+	arena_free(&cursor->sink.arena);
+	_c_yd_client_unref(cursor->client);
+	free(cursor->pages);
+	free(cursor->entries);
+	free(cursor->error);
+	free(cursor);
+}
+
+static c_yd_cursor_t *_c_yd_cursor_open(
+		c_yd_client_t *client, const char *api_suffix, const char *arg, 
+		int prefetch, char **error)
+{
+	c_yd_cursor_t *cursor = NEW(c_yd_cursor_t);
+	const char *fields;
+
+	if (cursor)
+		cursor->pages = calloc(
+				prefetch > 0 ? prefetch : client->config.ls_prefetch,
+				sizeof(struct _c_yd_ls_page));
+	if (!cursor || !cursor->pages){
+		free(cursor);
+		if (error)
+			*error = strdup("cYandexDisk: can't allocate memory");
+		return NULL;
+	}
+	
+	cursor->client = _c_yd_client_ref(client);
+	snprintf(cursor->api_suffix, sizeof(cursor->api_suffix), "%s", api_suffix);
+	fields = _c_yd_fields_arg(client, NULL, arg, true, cursor->arg, sizeof(cursor->arg));
+	if (fields != cursor->arg)
+		snprintf(cursor->arg, sizeof(cursor->arg), "%s", fields ? fields : "");
+	cursor->page_size = client->config.ls_page_size;
+	sprintf(cursor->limit, "limit=%d", cursor->page_size);
+	cursor->window = prefetch > 0 ? prefetch : client->config.ls_prefetch;
+	cursor->end = INT_MAX;
+	cursor->sync = _c_yd_in_engine(client);
+	pthread_mutex_init(&cursor->ls.lock, NULL);
+	pthread_cond_init(&cursor->ls.cond, NULL);
+	cursor->sink.user_data = cursor;
+	cursor->sink.entry_callback = _c_yd_cursor_item;
+	arena_init(&cursor->sink.arena, 0);
+
+	// first page tells if listing can be opened
+	if (_c_yd_cursor_page(cursor)){
+		if (error)
+			*error = cursor->error ? 
+				strdup(cursor->error) : strdup("cYandexDisk: can't list directory");
+		c_yd_cursor_close(cursor);
+		return NULL;
+	}
+	return cursor;
+}
+
+c_yd_cursor_t *c_yd_client_ls_open(c_yd_client_t *client, const char * path, int prefetch, char **error)
+{
+	char path_arg[BUFSIZ];
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+	return _c_yd_cursor_open(client, "v1/disk/resources", path_arg, prefetch, error);
+}
+
+c_yd_cursor_t *c_yd_client_trash_ls_open(c_yd_client_t *client, int prefetch, char **error)
+{
+	return _c_yd_cursor_open(client, "v1/disk/trash/resources", NULL, prefetch, error);
+}
+
+const c_yd_entry_t *c_yd_cursor_next(c_yd_cursor_t *cursor, char **error)
+{
+	while (cursor->pos == cursor->count) {
+		if (cursor->error || cursor->delivered >= cursor->end){
+			if (cursor->error && error)
+				*error = strdup(cursor->error);
+			return NULL;
+		}
+		_c_yd_cursor_page(cursor);
+	}
+	return &cursor->entries[cursor->pos++];
+}
+
+/* info of many resources - requests of next paths are
+ * queued when answers come, caller waits for all answers */
+struct _c_yd_stat;
+
+struct _c_yd_stat_slot {
+	struct _c_yd_stat *st;
+	int                i;          //index of path
+	unsigned long      generation; //of cache
+};
+
+struct _c_yd_stat {
+	c_yd_client_t          *client;
+	const char            **paths;
+	c_yd_stat_t            *stats;
+	struct _c_yd_stat_slot *slots;
+	int                     count;
+	int                     max;     //requests at once
+	int                     next;    //next path to request
+	int                     pending; //requests in engine
+	pthread_mutex_t         lock;
+	pthread_cond_t          cond;
+};
+
+void c_yd_stat_free(c_yd_stat_t *stats, int count)
+{
+	int i;
+	if (!stats)
+		return;
+	for (i = 0; i < count; ++i) {
+		free(stats[i].entry);
+		free(stats[i].error);
+	}
+	free(stats);
+}
+
+static void _c_yd_stat_error(c_yd_stat_t *stat, const char *error)
+{
+	stat->status = C_YD_STAT_ERROR;
+	stat->error = strdup(error);
+}
+
+/* result of path from answer - resource is put to cache and
+ * index */
+static void _c_yd_stat_result(
+		c_yd_client_t *client, struct _c_yd_stat_slot *slot, 
+		cJSON *json, long code, const char *error)
+{
+	struct _c_yd_stat *st = slot->st;
+	c_yd_stat_t *stat = &st->stats[slot->i];
+	const char *path = st->paths[slot->i];
+	c_yd_file_t *file;
+	c_yd_entry_t entry;
+	char buf[BUFSIZ];
+
+	if (error){
+		snprintf(buf, sizeof(buf), "cYandexDisk: %s", error);
+		_c_yd_stat_error(stat, buf);
+		return;
+	}
+	if (code == 404){
+		stat->status = C_YD_STAT_NOT_FOUND;
+		_c_yd_index_forget(client, path);
+		return;
+	}
+	if (code >= 300 || !json){
+		_c_yd_stat_error(stat, _c_yd_json_message(json, code, buf, sizeof(buf)));
+		return;
+	}
+
+	file = NEW(c_yd_file_t);
+	if (!file){
+		_c_yd_stat_error(stat, "cYandexDisk: can't allocate memory");
+		return;
+	}
+	c_json_to_c_yd_file_t(json, file);
+	_c_yd_file_to_entry(file, &entry);
+	stat->entry = c_yd_entry_dup(&entry);
+	if (stat->entry){
+		stat->status = C_YD_STAT_OK;
+		_c_yd_cache_put(client, YD_CACHE_INFO, path, &entry, 1, slot->generation);
+		_c_yd_index_put(client, NULL, &entry, 1);
+	} else
+		_c_yd_stat_error(stat, "cYandexDisk: can't allocate memory");
+	free(file);
+}
+
+static void _c_yd_stat_on_json(
+		struct _c_yd_request *req, cJSON *json, long code, const char *error);
+
+/* take cached results and queue requests of next paths up
+ * to limit - called with lock */
+static void _c_yd_stat_plan(struct _c_yd_stat *st)
+{
+	while (st->pending < st->max && st->next < st->count) {
+		struct _c_yd_stat_slot *slot = &st->slots[st->next++];
+		const char *path = st->paths[slot->i];
+		struct _c_yd_cache_item *item;
+		char path_arg[BUFSIZ], fields_arg[BUFSIZ];
+		int ret;
+
+		item = _c_yd_cache_get(st->client, YD_CACHE_INFO, path, &slot->generation);
+		if (item){
+			c_yd_stat_t *stat = &st->stats[slot->i];
+			stat->entry = c_yd_entry_dup(item->entries);
+			if (stat->entry)
+				stat->status = C_YD_STAT_OK;
+			else
+				_c_yd_stat_error(stat, "cYandexDisk: can't allocate memory");
+			_c_yd_cache_release(st->client->cache, item);
+			continue;
+		}
+
+		_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+		st->pending++;
+		pthread_mutex_unlock(&st->lock);
+		ret = _c_yd_engine_api(st->client, "GET", "v1/disk/resources", NULL, 0, 
+				slot, _c_yd_stat_on_json, 
+				_c_yd_fields_arg(st->client, NULL, path_arg, false, fields_arg, sizeof(fields_arg)), 
+				NULL);
+		pthread_mutex_lock(&st->lock);
+		if (ret){
+			_c_yd_stat_error(&st->stats[slot->i], "cYandexDisk: can't queue request");
+			st->pending--;
+		}
+	}
+}
+
+static void _c_yd_stat_on_json(
+		struct _c_yd_request *req, cJSON *json, long code, const char *error)
+{
+	struct _c_yd_stat_slot *slot = req->data;
+	struct _c_yd_stat *st = slot->st;
+
+	_c_yd_stat_result(req->client, slot, json, code, error);
+	if (json)
+		cJSON_Delete(json);
+
+	pthread_mutex_lock(&st->lock);
+	st->pending--;
+	_c_yd_stat_plan(st);
+	pthread_cond_signal(&st->cond);
+	pthread_mutex_unlock(&st->lock);
+}
+
+/* info of path in engine thread - engine would wait for itself */
+static void _c_yd_stat_sync(
+		c_yd_client_t *client, struct _c_yd_stat_slot *slot)
+{
+	const char *path = slot->st->paths[slot->i];
+	struct _c_yd_cache_item *item;
+	struct _c_yd_json_scope scope;
+	char path_arg[BUFSIZ], fields_arg[BUFSIZ];
+	char *error = NULL;
+	long code = 0;
+	cJSON *json;
+
+	item = _c_yd_cache_get(client, YD_CACHE_INFO, path, &slot->generation);
+	if (item){
+		c_yd_stat_t *stat = &slot->st->stats[slot->i];
+		stat->entry = c_yd_entry_dup(item->entries);
+		if (stat->entry)
+			stat->status = C_YD_STAT_OK;
+		else
+			_c_yd_stat_error(stat, "cYandexDisk: can't allocate memory");
+		_c_yd_cache_release(client->cache, item);
+		return;
+	}
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_code(client, &scope, &code, "GET", "v1/disk/resources", NULL, &error, 
+			_c_yd_fields_arg(client, NULL, path_arg, false, fields_arg, sizeof(fields_arg)), NULL);
+	if (error)
+		_c_yd_stat_error(&slot->st->stats[slot->i], error);
+	else
+		_c_yd_stat_result(client, slot, json, code, NULL);
+	if (json)
+		cJSON_Delete(json);
+	_c_yd_json_scope_end(&scope);
+	free(error);
+}
+
+c_yd_stat_t *c_yd_client_stat(c_yd_client_t *client, const char **paths, int count, int max_requests)
+{
+	struct _c_yd_stat st;
+	int i;
+
+	memset(&st, 0, sizeof(st));
+	st.client = client;
+	st.paths = paths;
+	st.count = count > 0 ? count : 0;
+	st.max = max_requests > 0 ? max_requests : YD_STAT_REQUESTS;
+	st.stats = calloc(st.count ? st.count : 1, sizeof(c_yd_stat_t));
+	st.slots = calloc(st.count ? st.count : 1, sizeof(struct _c_yd_stat_slot));
+	if (!st.stats || !st.slots){
+		free(st.stats);
+		free(st.slots);
+		return NULL;
+	}
+	for (i = 0; i < st.count; ++i) {
+		st.slots[i].st = &st;
+		st.slots[i].i = i;
+	}
+
+	if (_c_yd_in_engine(client)){
+		// one path after another
+		for (i = 0; i < st.count; ++i)
+			_c_yd_stat_sync(client, &st.slots[i]);
+		free(st.slots);
+		return st.stats;
+	}
+	
+	pthread_mutex_init(&st.lock, NULL);
+	pthread_cond_init(&st.cond, NULL);
+	pthread_mutex_lock(&st.lock);
+	_c_yd_stat_plan(&st);
+	while (st.pending || st.next < st.count)
+		pthread_cond_wait(&st.cond, &st.lock);
+	pthread_mutex_unlock(&st.lock);
+	pthread_mutex_destroy(&st.lock);
+	pthread_cond_destroy(&st.cond);
+
+	free(st.slots);
+	return st.stats;
+}
+
+/* change feed - disk revision tells if anything changed,
+ * last uploaded resources newer than checkpoint are passed */
+struct _c_yd_changes {
+	c_yd_int64_t  since;   //modified time of checkpoint
+	c_yd_int64_t  oldest;  //oldest item of answer
+	c_yd_int64_t  newest;  //newest item of answer
+	int           count;   //items in answer
+	c_yd_entry_t *entries; //items after checkpoint
+	int           len;
+	int           size;
+	int           newer;   //items newer than checkpoint
+	bool          failed;
+	void         *user_data;
+	int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error);
+};
+
+static int _c_yd_changes_item(
+		const c_yd_entry_t *entry, void *user_data, const char *error)
+{
+	struct _c_yd_changes *ch = user_data;
+	
+	if (error){
+		ch->failed = true;
+		if (ch->callback)
+			ch->callback(NULL, ch->user_data, error);
+		return 0;
+	}
+	
+	if (!ch->count++ || entry->modified > ch->newest)
+		ch->newest = entry->modified;
+	if (ch->count == 1 || entry->modified < ch->oldest)
+		ch->oldest = entry->modified;
+	
+	// resources of checkpoint time may be passed again
+	if (entry->modified < ch->since)
+		return 0;
+	if (entry->modified > ch->since)
+		ch->newer++;
+	if (ch->len == ch->size){
+		int size = ch->size ? ch->size * 2 : 64;
+		c_yd_entry_t *entries = 
+			realloc(ch->entries, size * sizeof(c_yd_entry_t));
+		if (!entries){
+			ch->failed = true;
+			if (ch->callback)
+				ch->callback(NULL, ch->user_data, "cYandexDisk: can't allocate memory");
+			return 0;
+		}
+		ch->entries = entries;
+		ch->size = size;
+	}
+	ch->entries[ch->len++] = *entry;
+	return 0;
+}
+
+/* revision of disk - return -1 on error */
+static c_yd_int64_t _c_yd_disk_revision(c_yd_client_t *client, char **error)
+{
+	struct _c_yd_json_scope scope;
+	c_yd_int64_t revision = -1;
+	cJSON *json, *item;
+
+	_c_yd_json_scope_begin(&scope);
+	json = _c_yd_client_api_scoped(client, &scope, "GET", "v1/disk", NULL, error, 
+			"fields=revision", NULL);
+	if (json){
+		item = cJSON_GetObjectItem(json, "revision");
+		if (cJSON_IsNumber(item))
+			revision = (c_yd_int64_t)item->valuedouble;
+		else if (error && !*error){
+			item = cJSON_GetObjectItem(json, "message");
+			*error = strdup(STR("cYandexDisk: %s", 
+						cJSON_IsString(item) ? item->valuestring : "no revision of disk"));
+		}
+		cJSON_Delete(json);
+	}
+	_c_yd_json_scope_end(&scope);
+	return revision;
+}
+
+/* last uploaded resources - return number of items or -1 */
+static int _c_yd_changes_get(
+		c_yd_client_t *client, const char *media_type, int limit, 
+		struct _c_yd_changes *ch, struct _c_yd_ls_sink *sink)
+{
+	char limit_arg[32], media_type_arg[BUFSIZ], fields_arg[BUFSIZ];
+	const char *arg;
+	int total;
+
+	sprintf(limit_arg, "limit=%d", limit);
+	if (media_type)
+		_c_yd_query_arg(media_type_arg, sizeof(media_type_arg), "media_type", media_type);
+	arg = _c_yd_fields_arg(client, NULL, media_type ? media_type_arg : NULL, true, 
+			fields_arg, sizeof(fields_arg));
+	if (arg == fields_arg){
+		// feed needs modified time of items
+		size_t len = strlen(fields_arg);
+		snprintf(fields_arg + len, sizeof(fields_arg) - len, ",items.modified");
+	}
+	
+	ch->count = ch->len = ch->newer = 0;
+	ch->oldest = ch->newest = 0;
+	arena_reset(&sink->arena);
+	_c_yd_ls_get(client, "v1/disk/resources/last-uploaded", limit_arg, arg, NULL, 
+			sink, &total);
+	return ch->failed ? -1 : ch->count;
+}
+
+int c_yd_client_changes(c_yd_client_t *client, c_yd_checkpoint_t *checkpoint, const char * media_type, void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
+{
+	struct _c_yd_changes ch;
+	struct _c_yd_ls_sink sink;
+	c_yd_int64_t revision;
+	char *error = NULL;
+	int limit = YD_CHANGES_LIMIT, count, i, ret = 0;
+
+	revision = _c_yd_disk_revision(client, &error);
+	if (revision < 0){
+		if (callback)
+			callback(NULL, user_data, error ? error : "cYandexDisk: can't get revision of disk");
+		free(error);
+		return -1;
+	}
+	if (checkpoint->revision && checkpoint->revision == revision)
+		return 0; // nothing changed
+
+	memset(&ch, 0, sizeof(ch));
+	ch.since = checkpoint->modified;
+	ch.user_data = user_data;
+	ch.callback = callback;
+	sink.user_data = &ch;
+	sink.callback = NULL;
+	sink.entry_callback = _c_yd_changes_item;
+	arena_init(&sink.arena, 0);
+
+	if (!checkpoint->revision){
+		// first call - checkpoint is set to newest resource
+		count = _c_yd_changes_get(client, media_type, 1, &ch, &sink);
+		if (count >= 0){
+			checkpoint->revision = revision;
+			checkpoint->modified = ch.newest;
+		}
+		ret = count < 0 ? -1 : C_YD_CHANGES_RESCAN;
+		goto end;
+	}
+	
+	// ask more items until answer reaches checkpoint
+	for (;;) {
+		count = _c_yd_changes_get(client, media_type, limit, &ch, &sink);
+		if (count < 0){
+			ret = -1;
+			goto end;
+		}
+		if (count < limit || ch.oldest < ch.since)
+			break;
+		if (limit >= YD_CHANGES_LIMIT_MAX){
+			ret = C_YD_CHANGES_RESCAN; // too many changes
+			break;
+		}
+		limit *= 10;
+	}
+
+	// revision is changed without uploads - resources were 
+	// deleted, moved or changed 
+	if (!ch.newer)
+		ret = C_YD_CHANGES_RESCAN;
+	
+	_c_yd_index_put(client, NULL, ch.entries, ch.len);
+
+	// from oldest to newest
+	for (i = ch.len - 1; i >= 0; --i) {
+		if (callback && callback(&ch.entries[i], user_data, NULL)){
+			// stopped - checkpoint is not moved
+			ret = -1;
+			goto end;
+		}
+	}
+
+	checkpoint->revision = revision;
+	if (ch.newest > checkpoint->modified)
+		checkpoint->modified = ch.newest;
+	if (client->index && ret == 0)
+		c_yd_index_set_revision(client->index, revision);
+
+end:
+	free(ch.entries);
+	arena_free(&sink.arena);
+	return ret;
+}
+
+/* write decimal number */
+static int _c_yd_int64_to_string(c_yd_int64_t n, char *buf)
+{
+	char tmp[24];
+	int len = 0, i = 0;
+	
+	if (n < 0){
+		buf[i++] = '-';
+		n = -n;
+	}
+	do {
+		tmp[len++] = (char)('0' + n % 10);
+		n /= 10;
+	} while (n);
+	while (len)
+		buf[i++] = tmp[--len];
+	buf[i] = 0;
+	return i;
+}
+
+int c_yd_checkpoint_to_string(const c_yd_checkpoint_t *checkpoint, char *buf, size_t size)
+{
+	char str[64];
+	int len = _c_yd_int64_to_string(checkpoint->revision, str);
+	str[len++] = ':';
+	len += _c_yd_int64_to_string(checkpoint->modified, str + len);
+	if ((size_t)len >= size)
+		return -1;
+	memcpy(buf, str, len + 1);
+	return len;
+}
+
+int c_yd_checkpoint_from_string(c_yd_checkpoint_t *checkpoint, const char *str)
+{
+	c_yd_int64_t n[2] = {0, 0};
+	int i, sign;
+
+	for (i = 0; i < 2; ++i) {
+		sign = 1;
+		if (*str == '-'){
+			sign = -1;
+			str++;
+		}
+		if (*str < '0' || *str > '9')
+			return -1;
+		while (*str >= '0' && *str <= '9')
+			n[i] = n[i] * 10 + (*str++ - '0');
+		n[i] *= sign;
+		if (i == 0 && *str++ != ':')
+			return -1;
+	}
+	if (*str)
+		return -1;
+	checkpoint->revision = n[0];
+	checkpoint->modified = n[1];
+	return 0;
+}
+
+/* upload and download */
+struct _c_yd_transfer_async {
+	FILE_TRANSFER file_transfer;
+	FILE *fp;
+	struct memory mem;
+	void *data;
+	void *user_data;
+	void (*callback)(FILE *fp, size_t size, void *user_data, const char *error);
+	void (*callback_data)(void *data, size_t size, void *user_data, const char *error);
+	void *clientp;
+	int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow);
+	c_yd_client_t *client;
+	char *path;            //uploaded resource - dropped from cache
+};
+
+static void _c_yd_transfer_async_finish(
+		struct _c_yd_transfer_async *ctx, void *data, size_t size, const char *error)
+{
+	if (ctx->path){
+		_c_yd_cache_drop(ctx->client, ctx->path);
+		_c_yd_index_forget(ctx->client, ctx->path);
+		free(ctx->path);
+	}
+	if (ctx->file_transfer == FILE_DOWNLOAD || ctx->file_transfer == FILE_UPLOAD){
+		if (ctx->callback)
+			ctx->callback(ctx->fp, size, ctx->user_data, error);
+	} else {
+		if (ctx->callback_data)
+			ctx->callback_data(data, size, ctx->user_data, error);
+	}
+	free(ctx);
+}
+
+static void _c_yd_transfer_async_setup(
+		struct _c_yd_request *req, CURL *curl)
+{
+	struct _c_yd_transfer_async *ctx = req->data;
+	struct stat file_info;
+
+	// no total timeout for transfers
+	curl_easy_setopt(curl, CURLOPT_TIMEOUT, 0L);
+
+	switch (ctx->file_transfer) {
+		case FILE_UPLOAD :
+			fstat(fileno(ctx->fp), &file_info);
+			curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+			curl_easy_setopt(curl, CURLOPT_READDATA, ctx->fp);
+			curl_easy_setopt(curl, CURLOPT_READFUNCTION, curl_upload_file_readfunc);
+			curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)file_info.st_size);
+			break;
+		case FILE_DOWNLOAD :
+			curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, NULL);
+			curl_easy_setopt(curl, CURLOPT_WRITEDATA, ctx->fp);
+			break;			
+		case DATA_UPLOAD :
+			curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+			curl_easy_setopt(curl, CURLOPT_READDATA, &ctx->mem);
+			curl_easy_setopt(curl, CURLOPT_READFUNCTION, curl_upload_data_readfunc);
+			curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)ctx->mem.size);
+			break;
+		case DATA_DOWNLOAD :
+			break;			
+		case DATA_STREAM :
+			// streams are made by curl_download_stream in 
+			// caller thread, never queued to engine
+			assert(!"stream transfer in engine");
+			break;
+	}
+
+	if (ctx->progress_callback) {
+#if LIBCURL_VERSION_NUM < 0x073200
+		curl_easy_setopt(curl, CURLOPT_PROGRESSDATA, ctx->clientp);
+		curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, ctx->progress_callback);
+		curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
+#else
+		curl_easy_setopt(curl, CURLOPT_XFERINFODATA, ctx->clientp);
+		curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, ctx->progress_callback);
+		curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0);
+#endif			
+	}
+}
+
+static void _c_yd_transfer_async_done(
+		struct _c_yd_request *req, CURL *curl, CURLcode res)
+{
+	struct _c_yd_transfer_async *ctx = req->data;
+	char error[64];
+	curl_off_t size = 0;
+	
+	if (ctx->file_transfer == FILE_DOWNLOAD)
+		fclose(ctx->fp);
+	
+	if (res != CURLE_OK){
+		snprintf(error, sizeof(error), 
+				"cYandexDisk: curl_easy_perform() failed: %d", res);
+		_c_yd_transfer_async_finish(ctx, ctx->data, 0, error);
+		return;
+	}
+
+	if (ctx->file_transfer == FILE_UPLOAD || ctx->file_transfer == DATA_UPLOAD){
+#if LIBCURL_VERSION_NUM >= 0x075500
+		curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_UPLOAD_T, &size);
+#else
+		curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_UPLOAD, &size);
+#endif
+	} else {
+#if LIBCURL_VERSION_NUM >= 0x071904
+		curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &size);
+#else
+		curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &size);
+#endif
+	}
+
+	_c_yd_transfer_async_finish(ctx, 
+			ctx->file_transfer == DATA_DOWNLOAD ? req->s.str : ctx->data, 
+			size, NULL);
+}
+
+/* got href - start transfer */
+static void _c_yd_transfer_async_on_json(
+		struct _c_yd_request *req, cJSON *json, long code, const char *error)
+{
+	struct _c_yd_transfer_async *ctx = req->data;
+	struct _c_yd_request *transfer;
+	char buf[BUFSIZ];
+	cJSON *href = cJSON_GetObjectItem(json, "href");
+	
+	if (error || !href || !href->valuestring){
+		if (error)
+			snprintf(buf, sizeof(buf), "cYandexDisk: %s", error);
+		else
+			_c_yd_json_message(json, code, buf, sizeof(buf));
+		if (json)
+			cJSON_Delete(json);
+		_c_yd_transfer_async_finish(ctx, ctx->data, 0, buf);
+		return;
+	}
+
+	transfer = _c_yd_request_new(ctx);
+	if (!transfer){
+		cJSON_Delete(json);
+		_c_yd_transfer_async_finish(ctx, ctx->data, 0, "cYandexDisk: can't allocate memory");
+		return;
+	}
+	snprintf(transfer->url, sizeof(transfer->url), "%s", href->valuestring);
+	cJSON_Delete(json);
+	transfer->setup = _c_yd_transfer_async_setup;
+	transfer->on_done = _c_yd_transfer_async_done;
+	if (_c_yd_engine_submit(req->client, transfer, 0))
+		_c_yd_transfer_async_finish(ctx, ctx->data, 0, "cYandexDisk: can't queue request");
+}
+
+static int _c_yd_transfer_async(
+		c_yd_client_t *client, const char *api_suffix, 
+		const char *arg1, const char *arg2,
+		struct _c_yd_transfer_async *_ctx)
+{
+	struct _c_yd_transfer_async *ctx = 
+		NEW(struct _c_yd_transfer_async);
+	if (!ctx)
+		return -1;
+	*ctx = *_ctx;
+	ctx->mem.data = ctx->data;
+	ctx->client = client;
+	if (_ctx->path){
+		_c_yd_cache_drop(client, _ctx->path);
+		_c_yd_index_forget(client, _ctx->path);
+		if (!(ctx->path = strdup(_ctx->path))){
+			free(ctx);
+			return -1;
+		}
+	}
+
+	if (_c_yd_engine_api(client, "GET", api_suffix, NULL, 0, ctx, 
+				_c_yd_transfer_async_on_json, arg1, arg2, NULL))
+	{
+		free(ctx->path);
+		free(ctx);
+		return -1;
+	}
+	return 0;
+}
+
+int c_yd_client_upload_file_async(c_yd_client_t *client, FILE *fp, const char * path, bool overwrite, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	struct _c_yd_transfer_async ctx = 
+		{FILE_UPLOAD, fp, {NULL, 0}, NULL, user_data, callback, NULL, clientp, progress_callback, NULL, (char *)path};
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	return _c_yd_transfer_async(client, "v1/disk/resources/upload", path_arg, overwrite_arg, &ctx);
+}
+
+int c_yd_client_upload_data_async(c_yd_client_t *client, void * data, size_t size, const char * path, bool overwrite, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char path_arg[BUFSIZ];
+	char overwrite_arg[32];
+	struct _c_yd_transfer_async ctx = 
+		{DATA_UPLOAD, NULL, {NULL, 0}, data, user_data, NULL, callback, clientp, progress_callback, NULL, (char *)path};
+	ctx.mem.size = size;
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	return _c_yd_transfer_async(client, "v1/disk/resources/upload", path_arg, overwrite_arg, &ctx);
+}
+
+int c_yd_client_download_file_async(c_yd_client_t *client, FILE *fp, const char * path, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char path_arg[BUFSIZ];
+	struct _c_yd_transfer_async ctx = 
+		{FILE_DOWNLOAD, fp, {NULL, 0}, NULL, user_data, callback, NULL, clientp, progress_callback, NULL, NULL};
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+	return _c_yd_transfer_async(client, "v1/disk/resources/download", path_arg, NULL, &ctx);
+}
+
+int c_yd_client_download_data_async(c_yd_client_t *client, const char * path, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char path_arg[BUFSIZ];
+	struct _c_yd_transfer_async ctx = 
+		{DATA_DOWNLOAD, NULL, {NULL, 0}, NULL, user_data, NULL, callback, clientp, progress_callback, NULL, NULL};
+
+	_c_yd_query_arg(path_arg, sizeof(path_arg), "path", path);
+	return _c_yd_transfer_async(client, "v1/disk/resources/download", path_arg, NULL, &ctx);
+}
+
+int c_yd_client_download_public_resource_async(c_yd_client_t *client, FILE *fp, const char * public_key, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char public_key_arg[BUFSIZ];
+	struct _c_yd_transfer_async ctx = 
+		{FILE_DOWNLOAD, fp, {NULL, 0}, NULL, user_data, callback, NULL, clientp, progress_callback, NULL, NULL};
+
+	_c_yd_query_arg(public_key_arg, sizeof(public_key_arg), "public_key", public_key);
+	return _c_yd_transfer_async(client, "v1/disk/public/resources/download", public_key_arg, NULL, &ctx);
+}
+
+int c_yd_client_download_public_resource_data_async(c_yd_client_t *client, const char * public_key, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	char public_key_arg[BUFSIZ];
+	struct _c_yd_transfer_async ctx = 
+		{DATA_DOWNLOAD, NULL, {NULL, 0}, NULL, user_data, NULL, callback, clientp, progress_callback, NULL, NULL};
+
+	_c_yd_query_arg(public_key_arg, sizeof(public_key_arg), "public_key", public_key);
+	return _c_yd_transfer_async(client, "v1/disk/public/resources/download", public_key_arg, NULL, &ctx);
+}
+
+/* functions with access_token argument - use client cached
+ * for token */
+
+#define YD_CLIENT_ERROR "cYandexDisk: can't create client"
+
+int c_yandex_disk_file_info(const char * token, const char * path, c_yd_file_t *file, char **_error)
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (_error)
+			*_error = strdup(YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_file_info(client, path, file, _error);
+	_c_yd_client_unref(client);
+	return ret;
+}
+
+int c_yandex_disk_upload_file(const char * token, FILE *fp, const char * path, bool overwrite, bool wait_finish, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(fp, 0, user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_upload_file(client, fp, path, overwrite, wait_finish, user_data, callback, clientp, progress_callback);
+	_c_yd_client_unref(client);
+	return ret;
+}
+
+int c_yandex_disk_upload_data(const char * token, void * data, size_t size, const char * path, bool overwrite, bool wait_finish, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(data, 0, user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_upload_data(client, data, size, path, overwrite, wait_finish, user_data, callback, clientp, progress_callback);
+	_c_yd_client_unref(client);
+	return ret;
+}
+
+int c_yandex_disk_download_file(const char * token, FILE *fp, const char * path, bool wait_finish, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(fp, 0, user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_download_file(client, fp, path, wait_finish, user_data, callback, clientp, progress_callback);
+	_c_yd_client_unref(client);
+	return ret;
+}
+
+int c_yandex_disk_download_file_resume(const char * token, const char * filepath, const char * path, bool verify, char **error, void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_download_file_resume(client, filepath, path, verify, error, clientp, progress_callback);
+	_c_yd_client_unref(client);
+	return ret;
+}
+
+int c_yandex_disk_download_data(const char * token, const char * path, bool wait_finish, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(NULL, 0, user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_download_data(client, path, wait_finish, user_data, callback, clientp, progress_callback);
+	_c_yd_client_unref(client);
+	return ret;
+}
+
+int c_yandex_disk_download_stream(const char * token, const char * path, bool wait_finish, void *user_data, int (*callback)(c_yd_stream_t *stream, const void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(NULL, NULL, 0, user_data, YD_CLIENT_ERROR);
+		return -1;
 	}
+	ret = c_yd_client_download_stream(client, path, wait_finish, user_data, callback, clientp, progress_callback);
+	_c_yd_client_unref(client);
+	return ret;
+}
 
-	if (!json) { //no json returned
+int c_yandex_disk_download_public_resource(const char * token, FILE *fp, const char * public_key, bool wait_finish, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(fp, 0, user_data, YD_CLIENT_ERROR);
 		return -1;
 	}
-	if (!cJSON_GetObjectItem(json, "path")){ //error to get info of file/directory
-		cJSON *message = cJSON_GetObjectItem(json, "error");
-		if (_error)
-			*_error = strdup(message->valuestring);
-		cJSON_free(json);
-		return -1;
-	}	
-	
-	if (file)
-		c_json_to_c_yd_file_t(json, file);
-	return 0;
+	ret = c_yd_client_download_public_resource(client, fp, public_key, wait_finish, user_data, callback, clientp, progress_callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_sort_ls(const char * token, const char * path, const char *sort, int l, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+int c_yandex_disk_download_public_resource_data(const char * token, const char * public_key, bool wait_finish, void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow))
 {
-	char path_sort_arg[BUFSIZ];
-	int i = 0, r = 0;
-	char limit[BUFSIZ], offset[BUFSIZ];
-	
-	sprintf(path_sort_arg, "path=%s&sort=%s", 
-			path, sort);	
-	sprintf(limit, "limit=%d", l<1?YD_ANSWER_LIMIT:l);
-	
-	do {
-		cJSON *json;
-		char *error = NULL;
-		
-		sprintf(offset, "offset=%d", i++ * l);
-		json = c_yandex_disk_api("GET", "v1/disk/resources", NULL, token, &error, path_sort_arg, limit, offset, NULL);
-		r = _c_yandex_disk_ls_parser(json, error, user_data, callback);
-	} while (r == 0 && l < 1);
-	return r;
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(NULL, 0, user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_download_public_resource_data(client, public_key, wait_finish, user_data, callback, clientp, progress_callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
 int c_yandex_disk_ls(const char * token, const char * path, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
 {
-	char path_arg[BUFSIZ];
-	int i = 0, r = 0, l = YD_ANSWER_LIMIT;
-	char limit[BUFSIZ], offset[BUFSIZ];
-	
-	sprintf(path_arg, "path=%s", path);	
-	sprintf(limit, "limit=%d", l);
-	
-	while	(r == 0) {
-		cJSON *json;
-		char *error = NULL;
-		
-		sprintf(offset, "offset=%d", i++ * l);
-		json = c_yandex_disk_api("GET", "v1/disk/resources", NULL, token, &error, path_arg, limit, offset, NULL);
-		r = _c_yandex_disk_ls_parser(json, error, user_data, callback);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(NULL, user_data, YD_CLIENT_ERROR);
+		return -1;
 	}
-	return r;
+	ret = c_yd_client_ls(client, path, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_ls_public(const char * token, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+int c_yandex_disk_ls_entries(const char * token, const char * path, void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
 {
-	
-	int i = 0, r = 0, l = YD_ANSWER_LIMIT;
-	char limit[BUFSIZ], offset[BUFSIZ];
-	
-	sprintf(limit, "limit=%d", l);
-	
-	while	(r == 0) {
-		cJSON *json;
-		char *error = NULL;
-		
-		sprintf(offset, "offset=%d", i++ * l);
-		json = c_yandex_disk_api("GET", "v1/disk/resources/public", NULL, token, &error, limit, offset, NULL);
-		r = _c_yandex_disk_ls_parser(json, error, user_data, callback);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(NULL, user_data, YD_CLIENT_ERROR);
+		return -1;
 	}
-	return r;
+	ret = c_yd_client_ls_entries(client, path, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int _c_yandex_disk_standart_parser(cJSON *json, char **error){
-	if (!json) //no json returned
-		return -1;
-
-	if (!cJSON_GetObjectItem(json, "href") && !cJSON_GetObjectItem(json, "path")){ //error to get info
-		cJSON *message = cJSON_GetObjectItem(json, "message");			
+c_yd_cursor_t *c_yandex_disk_ls_open(const char * token, const char * path, int prefetch, char **error)
+{
+	c_yd_cursor_t *cursor;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
 		if (error)
-			*error = strdup(STR("cYandexDisk: %s", message->valuestring));
-		cJSON_free(json);
-		return  -1;		
-	}	
-	cJSON_free(json);
-	return 0;	
+			*error = strdup(YD_CLIENT_ERROR);
+		return NULL;
+	}
+	cursor = c_yd_client_ls_open(client, path, prefetch, error);
+	_c_yd_client_unref(client);
+	return cursor;
 }
 
-
-int _c_yandex_disk_async_operation(const char * token, const char *operation_id, void *user_data, int(*callback)(void *user_data, const char *error))
+c_yd_cursor_t *c_yandex_disk_trash_ls_open(const char * token, int prefetch, char **error)
 {
-	cJSON *json;
-	char url_suffix[BUFSIZ];
-	char *error = NULL;
-	
-	sprintf(url_suffix, "v1/disk/operations/%s", operation_id);
-
-	json = c_yandex_disk_api("GET", url_suffix, NULL, token, &error, NULL);	
+	c_yd_cursor_t *cursor;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return NULL;
+	}
+	cursor = c_yd_client_trash_ls_open(client, prefetch, error);
+	_c_yd_client_unref(client);
+	return cursor;
+}
 
-	if (!json) { //no json returned
+int c_yandex_disk_files(const char * token, const char * media_type, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
 		if (callback)
-			callback(user_data,STR("cYandexDisk: %s", error));
+			callback(NULL, user_data, YD_CLIENT_ERROR);
 		return -1;
 	}
-	if (!cJSON_GetObjectItem(json, "href")){ //error to get info
-		cJSON *message = cJSON_GetObjectItem(json, "message");			
-		if (callback)
-			callback(user_data,STR("cYandexDisk: %s", message->valuestring));
-		cJSON_free(json);
-		return  -1;
-	}	
-
-	return 0;
+	ret = c_yd_client_files(client, media_type, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-struct _c_yandex_disk_async_parser_params {
-	char operation_id[BUFSIZ];
-	const char *token;
-	void *user_data;
-	int(*callback)(void *user_data, const char *error);
-};
-
-void * _c_yandex_disk_async_operation_in_thead(void *_params)
+int c_yandex_disk_changes(const char * token, c_yd_checkpoint_t *checkpoint, const char * media_type, void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error))
 {
-	struct _c_yandex_disk_async_parser_params *params = _params;
-	_c_yandex_disk_async_operation(params->token, params->operation_id, params->user_data, params->callback);
-	free(params);
-	pthread_exit(0);	
-	return NULL;
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(NULL, user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_changes(client, checkpoint, media_type, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int _c_yandex_disk_async_parser(cJSON *json, const char * token, void *user_data, int(*callback)(void *user_data, const char *error)){
-	
-	int err;
-	cJSON *operation_id;
-	pthread_t tid; //идентификатор потока
-	pthread_attr_t attr; //атрибуты потока
-	struct _c_yandex_disk_async_parser_params *params; 
+c_yd_stat_t *c_yandex_disk_stat(const char * token, const char **paths, int count, int max_requests)
+{
+	c_yd_stat_t *ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client)
+		return NULL;
+	ret = c_yd_client_stat(client, paths, count, max_requests);
+	_c_yd_client_unref(client);
+	return ret;
+}
 
-	if (!json) //no json returned
+int c_yandex_disk_walk(const char * token, const char * path, const c_yd_walk_config_t *config)
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (config && config->callback)
+			config->callback(NULL, 1, config->user_data, YD_CLIENT_ERROR);
 		return -1;
+	}
+	ret = c_yd_client_walk(client, path, config);
+	_c_yd_client_unref(client);
+	return ret;
+}
 
-	operation_id = cJSON_GetObjectItem(json, "href"); 
-	if (!operation_id){ //error to get info
-		cJSON *message = cJSON_GetObjectItem(json, "message");			
+int c_yandex_disk_sort_ls(const char * token, const char * path, const char *sort, int limit, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
 		if (callback)
-			callback(user_data, STR("cYandexDisk: %s", message->valuestring));
-		cJSON_free(json);
-		return  -1;		
-	}	
-
-	//получаем дефолтные значения атрибутов
-	err = pthread_attr_init(&attr);
-	if (err) {
-		perror("THREAD attributes");
-		cJSON_free(json);
-		return err;
-	}	
-
-	//set params
-	params = NEW(struct _c_yandex_disk_async_parser_params);
-	if (!params)
+			callback(NULL, user_data, YD_CLIENT_ERROR);
 		return -1;
-	strcpy(params->operation_id, operation_id->valuestring);
-	params->user_data = user_data;
-	params->callback = callback;
-	params->token = token;
-
-	cJSON_free(json);
-	
-	//создаем новый поток
-	err = pthread_create(&tid,&attr, _c_yandex_disk_async_operation_in_thead, params);
-	if (err) {
-		perror("create THREAD");
-		return err;
-	}	
-
-	return 0;	
+	}
+	ret = c_yd_client_sort_ls(client, path, sort, limit, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_mkdir(const char * token, const char * path, char **error)
+int c_yandex_disk_ls_public(const char * token, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
 {
-	char path_arg[BUFSIZ];
-	cJSON *json;
-
-	sprintf(path_arg, "path=%s", path);	
-	json = c_yandex_disk_api("PUT", "v1/disk/resources", NULL, token, error, path_arg, NULL);
-	return _c_yandex_disk_standart_parser(json, error);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(NULL, user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_ls_public(client, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_rm(const char * token, const char * path, char **error)
+int c_yandex_disk_public_ls(const char * token, const char * public_key, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
 {
-	char path_arg[BUFSIZ];
-	cJSON *json;
-
-	sprintf(path_arg, "path=%s", path);	
-	json = c_yandex_disk_api("DELETE", "v1/disk/resources", NULL, token, error, path_arg, NULL);
-	return _c_yandex_disk_standart_parser(json, error);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(NULL, user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_public_ls(client, public_key, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_patch(const char * token, const char * path, const char *json_data, char **error)
+int c_yandex_disk_trash_ls(const char * token, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
 {
-	char path_arg[BUFSIZ];
-	cJSON *json;
-
-	sprintf(path_arg, "path=%s", path);	
-	json = c_yandex_disk_api("PATCH", "v1/disk/resources", json_data, token, error, path_arg, NULL);
-	return _c_yandex_disk_standart_parser(json, error);
-	return 0;
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(NULL, user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_trash_ls(client, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_cp(const char * token, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
+char * c_yandex_disk_file_url(const char * token, const char * path, char **error)
 {
-	char from_arg[BUFSIZ];
-	char path_arg[BUFSIZ];
-	char overwrite_arg[32];
-	char async_arg[] = "force_async=true";
-	char *error = NULL;
-	cJSON *json;
-	
-	sprintf(from_arg, "from=%s", from);	
-	sprintf(path_arg, "path=%s", to);	
-	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	char *url;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return NULL;
+	}
+	url = c_yd_client_file_url(client, path, error);
+	_c_yd_client_unref(client);
+	return url;
+}
 
-	json = c_yandex_disk_api("POST", "v1/disk/resources/copy", NULL, token, &error, from_arg, path_arg, overwrite_arg, async_arg, NULL);
-	if (error) callback(user_data, error);
-	return _c_yandex_disk_async_parser(json, token, user_data, callback);
+int c_yandex_disk_mkdir(const char * token, const char * path, char **error)
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_mkdir(client, path, error);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_mv(const char * token, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
+int c_yandex_disk_rm(const char * token, const char * path, char **error)
 {
-	char from_arg[BUFSIZ];
-	char path_arg[BUFSIZ];
-	char overwrite_arg[32];
-	char async_arg[] = "force_async=true";
-	char *error = NULL;
-	cJSON *json;
-	
-	sprintf(from_arg, "from=%s", from);	
-	sprintf(path_arg, "path=%s", to);	
-	sprintf(overwrite_arg, "overwrite=%s", overwrite ? "true" : "false");		
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_rm(client, path, error);
+	_c_yd_client_unref(client);
+	return ret;
+}
 
-	json = c_yandex_disk_api("POST", "v1/disk/resources/move", NULL, token, &error, from_arg, path_arg, overwrite_arg, async_arg, NULL);
-	if (error) callback(user_data, error);
-	return _c_yandex_disk_async_parser(json, token, user_data, callback);
+int c_yandex_disk_patch(const char * token, const char * path, const char *json_data, char **error)
+{
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_patch(client, path, json_data, error);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
 int c_yandex_disk_publish(const char * token, const char * path, char **error)
 {
-	char path_arg[BUFSIZ];
-	cJSON *json;
-
-	sprintf(path_arg, "path=%s", path);	
-
-	json = c_yandex_disk_api("PUT", "v1/disk/resources/publish", NULL, token, error, path_arg, NULL);
-	return _c_yandex_disk_standart_parser(json, error);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_publish(client, path, error);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
 int c_yandex_disk_unpublish(const char * token, const char * path, char **error)
 {
-	char path_arg[BUFSIZ];
-	cJSON *json;
-
-	sprintf(path_arg, "path=%s", path);	
-
-	json = c_yandex_disk_api("PUT", "v1/disk/resources/unpublish", NULL, token, error, path_arg, NULL);
-	return _c_yandex_disk_standart_parser(json, error);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_unpublish(client, path, error);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_public_ls(const char * token, const char * public_key, void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error))
+int c_yandex_disk_trash_restore(const char * token, const char * path, char **error)
 {
-	char public_key_arg[BUFSIZ];
-	int i = 0, r = 0, l = YD_ANSWER_LIMIT;
-	char limit[BUFSIZ], offset[BUFSIZ];
-	
-	sprintf(public_key_arg, "public_key=%s", public_key);	
-	sprintf(limit, "limit=%d", l);
-	
-	while	(r == 0) {
-		cJSON *json;
-		char *error = NULL;
-
-		sprintf(offset, "offset=%d", i++ * l);
-		json = c_yandex_disk_api("GET", "v1/disk/public/resources", NULL, token, &error, public_key_arg, limit, offset, NULL);
-		r = _c_yandex_disk_ls_parser(json, error, user_data, callback);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return -1;
 	}
-	return r;
+	ret = c_yd_client_trash_restore(client, path, error);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_public_cp(const char * token, const char * public_key, const char * to, void *user_data, int(*callback)(void *user_data, const char *error))
+int c_yandex_disk_trash_empty(const char * token, char **error)
 {
-	char public_key_arg[BUFSIZ];
-	char save_path_arg[BUFSIZ];
-	char async_arg[] = "force_async=true";
-	char *error = NULL;
-	cJSON *json;
-	
-	sprintf(public_key_arg, "public_key=%s", public_key);	
-	sprintf(save_path_arg, "save_path=%s", to);	
-
-	json = c_yandex_disk_api("POST", "v1/disk/resources/copy", NULL, token, &error, public_key_arg, save_path_arg, async_arg, NULL);
-	if (error) 
-		if (callback)
-			callback(user_data, error);
-	return _c_yandex_disk_async_parser(json, token, user_data, callback);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (error)
+			*error = strdup(YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_trash_empty(client, error);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_trash_ls(
-		const char * token, 
-		void * user_data,          
-		int(*callback)(			       
-			const c_yd_file_t *file, 
-			void * user_data,	       
-			const char * error)
-		)
+int c_yandex_disk_cp(const char * token, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
 {
-	int i = 0, r = 0, l = YD_ANSWER_LIMIT;
-	char limit[BUFSIZ], offset[BUFSIZ];
-	
-	sprintf(limit, "limit=%d", l);
-	
-	while	(r == 0) {
-		cJSON *json;
-		char *error = NULL;
-		
-		sprintf(offset, "offset=%d", i++ * l);
-		json = c_yandex_disk_api("GET", "v1/disk/trash/resources", NULL, token, &error, limit, offset, NULL);
-		r = _c_yandex_disk_ls_parser(json, error, user_data, callback);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(user_data, YD_CLIENT_ERROR);
+		return -1;
 	}
-	return r;
-
-}	
+	ret = c_yd_client_cp(client, from, to, overwrite, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
+}
 
-int c_yandex_disk_trash_restore(const char * token, const char * path, char **error)
+int c_yandex_disk_mv(const char * token, const char * from, const char * to, bool overwrite, void *user_data, int(*callback)(void *user_data, const char *error))
 {
-	cJSON *json;
-	char path_arg[BUFSIZ];
-
-	sprintf(path_arg, "path=%s", path);	
-	json = c_yandex_disk_api("PUT", "v1/disk/trash/resources", NULL, token, error, path_arg, NULL);
-	return _c_yandex_disk_standart_parser(json, error);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_mv(client, from, to, overwrite, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
 
-int c_yandex_disk_trash_empty(const char * token, char **error)
+int c_yandex_disk_public_cp(const char * token, const char * public_key, const char * to, void *user_data, int(*callback)(void *user_data, const char *error))
 {
-	cJSON *json = c_yandex_disk_api("DELETE", "v1/disk/trash/resources", NULL, token, error, NULL);
-	return _c_yandex_disk_standart_parser(json, error);
+	int ret;
+	c_yd_client_t *client = _c_yd_client_for_token(token);
+	if (!client){
+		if (callback)
+			callback(user_data, YD_CLIENT_ERROR);
+		return -1;
+	}
+	ret = c_yd_client_public_cp(client, public_key, to, user_data, callback);
+	_c_yd_client_unref(client);
+	return ret;
 }
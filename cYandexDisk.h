@@ -2,11 +2,14 @@
  * File              : cYandexDisk.h
  * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
  * Date              : 03.05.2022
- * Last Modified Date: 23.04.2026
+ * Last Modified Date: 16.10.2026
  * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
  */
 /*
  * C API for Yandex Disk
+ *
+ * Paths and public keys are given as is (not URL-encoded) -
+ * library encodes them for every request
  */
 #ifndef C_YANDEX_DISK
 #define C_YANDEX_DISK
@@ -40,8 +43,124 @@ typedef struct c_yd_file_t {
 	char   preview[BUFSIZ];		//url of preview
 	char   public_key[BUFSIZ];
 	char   public_url[BUFSIZ];
+	char   md5[33];				//MD5 hash of file
+	char   sha256[65];			//SHA256 hash of file
 } c_yd_file_t;
 
+#if defined(_MSC_VER) && _MSC_VER < 1600
+typedef __int64 c_yd_int64_t;
+#else
+#include <stdint.h>
+typedef int64_t c_yd_int64_t;
+#endif
+
+/* compact yandex disk resource - strings point to memory
+ * of listing page and are valid until callback returns
+ * (empty string if not set) */
+typedef struct c_yd_entry_t {
+	const char  *name;        //name of resource
+	const char  *type;        //type of resource (file, dir)
+	const char  *path;        //path of resource in disk
+	const char  *mime_type;
+	const char  *preview;     //url of preview
+	const char  *public_key;
+	const char  *public_url;
+	const char  *md5;         //MD5 hash of file
+	const char  *sha256;      //SHA256 hash of file
+	c_yd_int64_t size;
+	c_yd_int64_t created;     //unix time
+	c_yd_int64_t modified;    //unix time
+} c_yd_entry_t;
+
+// copy entry to keep it after callback - free with free()
+extern c_yd_entry_t *c_yd_entry_dup(const c_yd_entry_t *entry);
+
+/*
+ * Walk of directory tree - directories are listed breadth-first
+ * with many listing requests at once, callbacks are called in
+ * caller thread
+ */
+#define C_YD_WALK_PRUNE 1
+
+typedef struct c_yd_walk_config_t {
+	int  max_depth;    //levels of tree to list - 1 lists only root
+	                   //directory (0 - no limit)
+	int  concurrency;  //listing requests at once (0 - 8)
+	int  page_size;    //items in one listing request (0 - 100)
+	void *user_data;
+	//called for every resource - return 0 to continue, 
+	//C_YD_WALK_PRUNE to not enter directory or -1 to stop walk
+	int (*callback)(
+			const c_yd_entry_t *entry, //resource (NULL on error)
+			int depth,                 //1 for items of root directory
+			void *user_data,
+			const char *error);        //error of directory listing
+	//called when directory is listed with all its items (valid
+	//until callback returns) - return 0 to continue or -1 to stop
+	int (*dir_callback)(
+			const char *path,          //path of directory
+			const c_yd_entry_t *entries,
+			int count,
+			int depth,                 //depth of items
+			void *user_data,
+			const char *error);        //error of directory listing
+} c_yd_walk_config_t;
+
+/*
+ * Change feed - disk revision tells if disk is changed and
+ * last uploaded resources are passed since checkpoint. Keep
+ * checkpoint between runs (see c_yd_checkpoint_to_string)
+ */
+#define C_YD_CHANGES_RESCAN 1
+
+typedef struct c_yd_checkpoint_t {
+	c_yd_int64_t revision;    //revision of disk (0 - not set)
+	c_yd_int64_t modified;    //unix time of newest passed resource
+} c_yd_checkpoint_t;
+
+// checkpoint as string "revision:modified" - return length 
+// or -1 if buf is too small
+extern int c_yd_checkpoint_to_string(
+		const c_yd_checkpoint_t *checkpoint, char *buf, size_t size);
+
+// read checkpoint from string - return 0 on success
+extern int c_yd_checkpoint_from_string(
+		c_yd_checkpoint_t *checkpoint, const char *str);
+
+/*
+ * Info of many resources at once - requests of paths are
+ * sent concurrently, result of every path is in array in
+ * order of paths
+ */
+typedef enum c_yd_stat_status_t {
+	C_YD_STAT_OK,          //entry is set
+	C_YD_STAT_NOT_FOUND,   //resource does not exist
+	C_YD_STAT_ERROR,       //error is set
+} c_yd_stat_status_t;
+
+typedef struct c_yd_stat_t {
+	c_yd_stat_status_t status;
+	c_yd_entry_t      *entry;  //resource
+	char              *error;  //error of request
+} c_yd_stat_t;
+
+// free results of stat
+extern void c_yd_stat_free(c_yd_stat_t *stats, int count);
+
+/*
+ * Cursor of directory listing - caller takes resources one
+ * by one while next pages are asked in background
+ */
+typedef struct c_yd_cursor c_yd_cursor_t;
+
+// next resource or NULL at end of listing or on error (error
+// is set) - entry is valid until next call
+extern const c_yd_entry_t *c_yd_cursor_next(
+		c_yd_cursor_t *cursor, char **error);
+
+// stop listing and free cursor
+extern void c_yd_cursor_close(c_yd_cursor_t *cursor);
+
 
 // get info of file/directory
 extern int c_yandex_disk_file_info(
@@ -51,6 +170,14 @@ extern int c_yandex_disk_file_info(
 		char **_error
 		);
 
+//info of many files/directories - see c_yd_client_stat
+extern c_yd_stat_t *c_yandex_disk_stat(
+		const char * access_token, //authorization token
+		const char **paths,        //paths in yandex disk
+		int count,                 //number of paths
+		int max_requests           //requests at once (0 - 8)
+		);
+
 
 //upload file to Yandex Disk
 extern int c_yandex_disk_upload_file(
@@ -124,6 +251,28 @@ extern int c_yandex_disk_download_file(
 		)
 );
 
+//Download file from Yandex Disk to filepath continuing partial
+//local file - blocks until download is finished, gets new download
+//url for every retry and checks SHA256 (or MD5 if SHA256 is not
+//known) of file if verify is true. Remote file of partial download
+//is kept in filepath.ydresume - download starts again if remote
+//file was changed or partial file was not made by this function
+extern int c_yandex_disk_download_file_resume(             
+		const char * access_token, //authorization token
+		const char * filepath,     //local file path - created if not exists
+		const char * path,         //path in yandex disk of file to download - start with app:/
+		bool verify,               //check hash of downloaded file
+		char **error,              //error
+		void *clientp,			   //data pointer to transfer trow progress callback
+		int (*progress_callback)(  //progress callback function
+			void *clientp,		   //data pointer return from progress function
+			double dltotal,        //size of file
+			double dlnow,		   //size of local file
+			double ultotal,        //not used
+			double ulnow           //not used
+		)
+);
+
 //Download data from Yandex Disk - return data size
 extern int c_yandex_disk_download_data(             
 		const char * access_token, //authorization token
@@ -146,6 +295,42 @@ extern int c_yandex_disk_download_data(
 		)
 );
 
+// return from stream callback to pause download - the same 
+// chunk is delivered again after c_yd_stream_resume
+#define C_YD_STREAM_PAUSE 1
+
+typedef struct c_yd_stream c_yd_stream_t;
+
+// resume paused download - may be called from any thread
+// while or after callback returns C_YD_STREAM_PAUSE, call for
+// running download is ignored
+extern void c_yd_stream_resume(c_yd_stream_t *stream);
+
+//Download file from Yandex Disk by chunks - callback is called
+//for every received chunk and at the end with NULL data
+extern int c_yandex_disk_download_stream(             
+		const char * access_token, //authorization token
+		const char * path,         //path in yandex disk of file to download - start with app:/
+		bool wait_finish,
+		void *user_data,           //pointer of data to transfer throw callback
+		int (*callback)(		   //callback function - return 0 to continue, 
+			                       //C_YD_STREAM_PAUSE to pause or -1 to stop
+			c_yd_stream_t *stream, //download stream (NULL if download is not started)
+			const void *data,	   //received chunk (NULL if download finished)
+			size_t size,           //size of chunk (downloaded size if finished)
+			void *user_data,       //pointer of data return from callback
+			const char *error	   //error
+		), 
+		void *clientp,			   //data pointer to transfer trow progress callback
+		int (*progress_callback)(  //progress callback function
+			void *clientp,		   //data pointer return from progress function
+			double dltotal,        //downloaded total size
+			double dlnow,		   //downloaded size
+			double ultotal,        //uploaded total size
+			double ulnow           //uploaded size
+		)
+);
+
 //list directory or get info of file
 extern int c_yandex_disk_ls(			   
 		const char * access_token, //authorization token
@@ -158,6 +343,65 @@ extern int c_yandex_disk_ls(
 		)
 );
 
+//list directory or get info of file with compact records
+extern int c_yandex_disk_ls_entries(			   
+		const char * access_token, //authorization token
+		const char * path,		   //path in yandex disk (file or directory)
+		void * user_data,		   //pointer of data return from callback 
+		int(*callback)(			   //callback function
+			const c_yd_entry_t *entry,   //information of resource 
+			void * user_data,	   //pointer of data return from callback 
+			const char * error	   //error
+		)
+);
+
+//open cursor of directory listing - see c_yd_client_ls_open
+extern c_yd_cursor_t *c_yandex_disk_ls_open(
+		const char * access_token, //authorization token
+		const char * path,         //path in yandex disk (file or directory)
+		int prefetch,              //pages asked ahead (0 - 4)
+		char **error               //error
+);
+
+//open cursor of trash listing
+extern c_yd_cursor_t *c_yandex_disk_trash_ls_open(
+		const char * access_token, //authorization token
+		int prefetch,              //pages asked ahead (0 - 4)
+		char **error               //error
+);
+
+//flat list of all files of disk
+extern int c_yandex_disk_files(			   
+		const char * access_token, //authorization token
+		const char * media_type,   //comma separated media types or NULL for all files
+		void * user_data,		   //pointer of data return from callback 
+		int(*callback)(			   //callback function
+			const c_yd_file_t *file,   //information of file 
+			void * user_data,	   //pointer of data return from callback 
+			const char * error	   //error
+		)
+);
+
+//uploaded resources since checkpoint - see c_yd_client_changes
+extern int c_yandex_disk_changes(
+		const char * access_token, //authorization token
+		c_yd_checkpoint_t *checkpoint,
+		const char * media_type,   //comma separated media types or NULL for all files
+		void * user_data,		   //pointer of data return from callback 
+		int(*callback)(			   //callback function
+			const c_yd_entry_t *entry, //uploaded resource 
+			void * user_data,	   //pointer of data return from callback 
+			const char * error	   //error
+		)
+);
+
+//walk directory tree - see c_yd_client_walk
+extern int c_yandex_disk_walk(
+		const char * access_token, //authorization token
+		const char * path,         //path of root directory
+		const c_yd_walk_config_t *config
+);
+
 //list directory or get info of file
 extern int c_yandex_disk_sort_ls(			   
 		const char * access_token, //authorization token
@@ -197,7 +441,8 @@ extern int c_yandex_disk_rm(const char * access_token, const char * path, char *
 //update resource data
 extern int c_yandex_disk_patch(const char * access_token, const char * path, const char *json_data, char **error);
 
-//copy file from to
+//copy file from to - callback is called when operation
+//finished (in engine thread if operation was started)
 extern int c_yandex_disk_cp(
 		const char * access_token, //authorization token
 		const char * from,		   //from path in Yandex Disk 
@@ -210,7 +455,7 @@ extern int c_yandex_disk_cp(
 		)
 );
 
-//move file from to
+//move file from to - callback is called when operation finished
 extern int c_yandex_disk_mv(
 		const char * access_token, //authorization token
 		const char * from,		   //from path in Yandex Disk 
@@ -285,7 +530,8 @@ extern int c_yandex_disk_download_public_resource_data(
 		)
 );
 
-//copy public resource to Yandex Disk
+//copy public resource to Yandex Disk - callback is called when
+//operation finished
 extern int c_yandex_disk_public_cp(
 		const char * access_token, //authorization token
 		const char * public_key,   //from path in public resource of Yandex Disk 
@@ -314,11 +560,504 @@ extern int c_yandex_disk_trash_restore(const char * access_token, const char * p
 //clear trash - remove all files
 extern int c_yandex_disk_trash_empty(const char * access_token, char **error);
 
+/*
+ * Client session
+ * c_yd_client_t owns access token, prebuilt request headers
+ * and keep-alive connections. Create it once and use
+ * c_yd_client_* functions instead of functions with
+ * access_token argument.
+ */
+
+/* client session configuration */
+typedef struct c_yd_client_config_t {
+	long connect_timeout;     //connection timeout in seconds (0 - curl default)
+	long timeout;             //API request timeout in seconds (0 - no timeout)
+	long buffer_size;         //curl receive buffer size (0 - curl default)
+	int  max_connections;     //number of idle keep-alive connections to keep
+	int  concurrency;         //max number of API requests at once (0 - no limit)
+	bool http2;               //multiplex API requests as HTTP/2 streams -
+	                          //synchronous requests of all threads are also
+	                          //made by client engine (falls back to HTTP/1.1
+	                          //if not supported)
+	int  max_streams;         //max HTTP/2 streams per connection (0 - server limit)
+	int  download_streams;    //parallel range requests to download file (0 - one stream)
+	size_t download_chunk_size; //size of range in bytes (0 - 8Mb)
+	int  transfer_workers;    //threads for transfers without wait_finish (0 - 4)
+	int  transfer_queue;      //max queued transfers - new transfer waits
+	                          //if queue is full (0 - no limit)
+	int  ls_page_size;        //items in one page of directory listing (0 - 20)
+	int  ls_prefetch;         //pages of directory listing requested at once
+	                          //(0 - 4, 1 - one page after another)
+	bool ls_unordered;        //pass prefetched pages to callback as they
+	                          //arrive - not in directory order
+	const char *fields;       //comma separated resource fields asked in
+	                          //listing and info answers (NULL - fields
+	                          //of c_yd_file_t, "" - all fields)
+	int  cache_ttl;           //seconds to keep file info and directory
+	                          //listings in cache (0 - no cache)
+	size_t cache_size;        //max bytes of cache (0 - 1Mb)
+	bool json_arena;          //parse answers in memory of request and
+	                          //release it at once - sets cJSON hooks
+	                          //for whole process (see c_yd_client_new)
+} c_yd_client_config_t;
+
+typedef struct c_yd_client c_yd_client_t;
+
+// set default configuration
+extern void c_yd_client_config_init(c_yd_client_config_t *config);
+
+// allocate and return new client session or NULL on error
+// (config may be NULL for defaults)
+// If json_arena is set library replaces cJSON allocator of whole
+// process (cJSON_InitHooks) to parse answers in memory of request -
+// outside requests hooks call malloc/free. Application should not
+// set own hooks, and cJSON memory allocated before the first such
+// client must be released with cJSON_Delete/cJSON_free
+extern c_yd_client_t *c_yd_client_new(
+		const char *access_token, 
+		const c_yd_client_config_t *config);
+
+// free client session - it is released when all asynchronous
+// operations of client are finished
+extern void c_yd_client_free(c_yd_client_t *client);
+
+/* counters of metadata cache (cache_ttl in config) - file
+ * info and directory listings are cached and dropped when 
+ * client changes resource */
+typedef struct c_yd_cache_stats_t {
+	unsigned long hits;
+	unsigned long misses;
+	int           count;      //cached file infos and listings
+	size_t        size;       //bytes of cache
+} c_yd_cache_stats_t;
+
+extern void c_yd_client_cache_stats(
+		c_yd_client_t *client, c_yd_cache_stats_t *stats);
+
+// drop all cached answers - changes made by other clients
+// are seen after cache_ttl or when cache is cleared
+extern void c_yd_client_cache_clear(c_yd_client_t *client);
+
+/*
+ * Persistent index of disk tree - resources from directory
+ * listings, walks, file infos and change feed are kept in
+ * memory-mapped file and found by path without requests.
+ * Resources changed by client requests are changed in index
+ * (or removed if result is not known). Index can be shared by
+ * clients and is opened again after restart; index not closed
+ * after crash is empty.
+ */
+typedef struct c_yd_index c_yd_index_t;
+
+// open or create index file - return NULL on error
+// (index needs mmap - not supported on Windows)
+extern c_yd_index_t *c_yd_index_open(
+		const char *filepath, char **error);
+
+// write index and close - clients should not use index
+extern void c_yd_index_close(c_yd_index_t *index);
+
+// write changes to file - return 0 on success
+extern int c_yd_index_sync(c_yd_index_t *index);
+
+// use index in client requests (NULL - no index) - set
+// before requests of client
+extern void c_yd_client_set_index(
+		c_yd_client_t *client, c_yd_index_t *index);
+
+// resource from index or NULL if not known - free with free()
+// (entry has name, type, path, size, modified and hashes)
+extern c_yd_entry_t *c_yd_index_get(
+		c_yd_index_t *index, const char *path);
+
+// pass known items of directory to callback - return number
+// of items or -1 if directory was not listed
+extern int c_yd_index_ls(
+		c_yd_index_t *index,
+		const char *path,
+		void *user_data,
+		int(*callback)(
+			const c_yd_entry_t *entry,
+			void *user_data,
+			const char *error));
+
+// number of resources in index
+extern int c_yd_index_count(c_yd_index_t *index);
+
+// revision of disk when index was updated with change feed
+// (0 - not known)
+extern c_yd_int64_t c_yd_index_revision(c_yd_index_t *index);
+extern void c_yd_index_set_revision(
+		c_yd_index_t *index, c_yd_int64_t revision);
+
+/*
+ * Transfers without wait_finish are queued to worker threads 
+ * of client (transfer_workers in config). Functions with _job 
+ * suffix return handle of queued transfer (or copy/move 
+ * operation) or NULL if it is not started.
+ */
+typedef struct c_yd_job c_yd_job_t;
+
+typedef enum c_yd_job_status {
+	C_YD_JOB_QUEUED,      //waiting for worker thread
+	C_YD_JOB_RUNNING,
+	C_YD_JOB_DONE,        //finished without error
+	C_YD_JOB_FAILED,
+	C_YD_JOB_CANCELLED,
+} c_yd_job_status_t;
+
+// wait until transfer is finished
+extern void c_yd_job_wait(c_yd_job_t *job);
+
+// wait timeout milliseconds (<0 - no timeout) - return 0 if
+// job is finished
+extern int c_yd_job_wait_timeout(c_yd_job_t *job, long timeout);
+
+// wait until all jobs (or any job if all is false) are finished
+// or timeout (ms, <0 - no timeout) - return number of finished 
+// jobs (NULL jobs are skipped)
+extern int c_yd_job_wait_many(
+		c_yd_job_t **jobs, int count, bool all, long timeout);
+
+extern c_yd_job_status_t c_yd_job_status(c_yd_job_t *job);
+
+// cancel job - queued transfer is removed from queue, running
+// transfer is stopped, copy/move is not waited any more (but
+// operation is not stopped on server); callback gets error
+extern void c_yd_job_cancel(c_yd_job_t *job);
+
+// transferred bytes of finished job
+extern size_t c_yd_job_bytes(c_yd_job_t *job);
+
+// error of finished job or NULL - valid until job is freed
+extern const char *c_yd_job_error(c_yd_job_t *job);
+
+// free transfer handle - transfer is not stopped
+extern void c_yd_job_free(c_yd_job_t *job);
+
+// wait until all queued transfers of client are finished
+// (do not call from transfer callback)
+extern void c_yd_client_transfers_drain(c_yd_client_t *client);
+
+// cancel queued transfers (callbacks get error), wait running
+// transfers and stop worker threads - threads are started again
+// by next transfer
+extern void c_yd_client_transfers_shutdown(c_yd_client_t *client);
+
+// client variants of functions above - same arguments
+// without access_token
+extern int c_yd_client_file_info(
+		c_yd_client_t *client, const char * path, c_yd_file_t *file, char **_error);
+
+// info with comma separated resource fields of this call (NULL - 
+// fields of client config, "" - all fields) - answer with own 
+// fields is not cached
+extern int c_yd_client_file_info_fields(
+		c_yd_client_t *client, const char * path, const char * fields, 
+		c_yd_file_t *file, char **_error);
+
+extern int c_yd_client_upload_file(
+		c_yd_client_t *client, FILE *fp, const char * path, bool overwrite, bool wait_finish,
+		void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_upload_data(
+		c_yd_client_t *client, void * data, size_t size, const char * path, bool overwrite, bool wait_finish,
+		void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_download_file(
+		c_yd_client_t *client, FILE *fp, const char * path, bool wait_finish,
+		void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern c_yd_job_t *c_yd_client_upload_file_job(
+		c_yd_client_t *client, FILE *fp, const char * path, bool overwrite,
+		void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern c_yd_job_t *c_yd_client_upload_data_job(
+		c_yd_client_t *client, void * data, size_t size, const char * path, bool overwrite,
+		void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern c_yd_job_t *c_yd_client_download_file_job(
+		c_yd_client_t *client, FILE *fp, const char * path,
+		void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern c_yd_job_t *c_yd_client_download_data_job(
+		c_yd_client_t *client, const char * path,
+		void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_download_stream(
+		c_yd_client_t *client, const char * path, bool wait_finish,
+		void *user_data, int (*callback)(c_yd_stream_t *stream, const void *data, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_download_file_resume(
+		c_yd_client_t *client, const char * filepath, const char * path, bool verify, char **error,
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_download_data(
+		c_yd_client_t *client, const char * path, bool wait_finish,
+		void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+// items are passed to callback in caller thread - pages
+// of large directory are requested at once (ls_prefetch)
+extern int c_yd_client_ls(
+		c_yd_client_t *client, const char * path, 
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+extern int c_yd_client_sort_ls(
+		c_yd_client_t *client, const char * path, const char * sort, int limit,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+// listings with resource fields of this call - see 
+// c_yd_client_file_info_fields
+extern int c_yd_client_ls_fields(
+		c_yd_client_t *client, const char * path, const char * fields,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+extern int c_yd_client_sort_ls_fields(
+		c_yd_client_t *client, const char * path, const char * sort, int limit, const char * fields,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+extern int c_yd_client_ls_public(
+		c_yd_client_t *client, 
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+extern char * c_yd_client_file_url(c_yd_client_t *client, const char * path, char **error);
+
+extern int c_yd_client_mkdir(c_yd_client_t *client, const char * path, char **error);
+
+extern int c_yd_client_rm(c_yd_client_t *client, const char * path, char **error);
+
+extern int c_yd_client_patch(c_yd_client_t *client, const char * path, const char *json_data, char **error);
+
+extern int c_yd_client_cp(
+		c_yd_client_t *client, const char * from, const char * to, bool overwrite,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_mv(
+		c_yd_client_t *client, const char * from, const char * to, bool overwrite,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_publish(c_yd_client_t *client, const char * path, char **error);
+
+extern int c_yd_client_unpublish(c_yd_client_t *client, const char * path, char **error);
+
+extern int c_yd_client_public_ls(
+		c_yd_client_t *client, const char * public_key,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+extern int c_yd_client_download_public_resource(
+		c_yd_client_t *client, FILE *fp, const char * public_key, bool wait_finish,
+		void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_download_public_resource_data(
+		c_yd_client_t *client, const char * public_key, bool wait_finish,
+		void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_public_cp(
+		c_yd_client_t *client, const char * public_key, const char * to,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_trash_ls(
+		c_yd_client_t *client,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+// listing with compact records - see c_yd_entry_t
+extern int c_yd_client_ls_entries(
+		c_yd_client_t *client, const char * path, 
+		void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error));
+
+extern int c_yd_client_public_ls_entries(
+		c_yd_client_t *client, const char * public_key,
+		void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error));
+
+extern int c_yd_client_trash_ls_entries(
+		c_yd_client_t *client,
+		void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error));
+
+// flat list of all files of disk without directories, media_type
+// is comma separated list of types (audio, image, video, document, 
+// ...) or NULL for all files
+extern int c_yd_client_files(
+		c_yd_client_t *client, const char * media_type,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+extern int c_yd_client_files_entries(
+		c_yd_client_t *client, const char * media_type,
+		void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error));
+
+// open cursor of directory listing - prefetch pages are asked
+// ahead while caller takes resources (0 - ls_prefetch of config);
+// first page is asked before return, return NULL on error
+extern c_yd_cursor_t *c_yd_client_ls_open(
+		c_yd_client_t *client, const char * path, int prefetch,
+		char **error);
+
+extern c_yd_cursor_t *c_yd_client_trash_ls_open(
+		c_yd_client_t *client, int prefetch, char **error);
+
+// pass resources uploaded since checkpoint from oldest to newest
+// (resources of checkpoint time may be passed again) and move
+// checkpoint - nothing is asked but revision if disk is not changed.
+// Feed has no deleted or moved resources: return 0 if changes are 
+// passed, C_YD_CHANGES_RESCAN if disk should be listed again (first 
+// call, too many changes or disk is changed without uploads) or -1 
+// on error or if callback returned non-zero - checkpoint is not 
+// moved then
+extern int c_yd_client_changes(
+		c_yd_client_t *client, c_yd_checkpoint_t *checkpoint,
+		const char * media_type,
+		void * user_data, int(*callback)(const c_yd_entry_t *entry, void * user_data, const char * error));
+
+// set default walk configuration
+extern void c_yd_walk_config_init(c_yd_walk_config_t *config);
+
+// walk tree from path (order of directories of one level is not
+// defined) - return 0 when tree is walked or -1 if walk is stopped 
+// by callback or on error; errors of directory listing are passed
+// to callbacks and do not stop walk
+extern int c_yd_client_walk(
+		c_yd_client_t *client, const char * path, 
+		const c_yd_walk_config_t *config);
+
+// info of count paths with max_requests requests at once (0 - 8)
+// - return array of count results (free with c_yd_stat_free) or
+// NULL if memory can't be allocated; cached info is used
+extern c_yd_stat_t *c_yd_client_stat(
+		c_yd_client_t *client, const char **paths, int count,
+		int max_requests);
+
+extern int c_yd_client_trash_restore(c_yd_client_t *client, const char * path, char **error);
+
+extern int c_yd_client_trash_empty(c_yd_client_t *client, char **error);
+
+/*
+ * Asynchronous client functions
+ * Requests are queued to client engine and run at once
+ * with curl_multi in one driver thread. Callbacks are
+ * called from driver thread. Functions return 0 if request
+ * was queued.
+ */
+
+// wait until all asynchronous requests of client finished
+extern void c_yd_client_wait_async(c_yd_client_t *client);
+
+// callback is called with NULL error on success
+extern int c_yd_client_mkdir_async(c_yd_client_t *client, const char * path,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_rm_async(c_yd_client_t *client, const char * path,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_patch_async(c_yd_client_t *client, const char * path, const char *json_data,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_publish_async(c_yd_client_t *client, const char * path,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_unpublish_async(c_yd_client_t *client, const char * path,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_trash_restore_async(c_yd_client_t *client, const char * path,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_trash_empty_async(c_yd_client_t *client,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+// callback is called when operation on server is finished
+extern int c_yd_client_cp_async(c_yd_client_t *client, const char * from, const char * to, bool overwrite,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_mv_async(c_yd_client_t *client, const char * from, const char * to, bool overwrite,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern int c_yd_client_public_cp_async(c_yd_client_t *client, const char * public_key, const char * to,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+// copy/move with handle (see c_yd_job_t) - NULL if request is
+// not queued
+extern c_yd_job_t *c_yd_client_cp_job(c_yd_client_t *client, const char * from, const char * to, bool overwrite,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+extern c_yd_job_t *c_yd_client_mv_job(c_yd_client_t *client, const char * from, const char * to, bool overwrite,
+		void *user_data, int(*callback)(void *user_data, const char *error));
+
+// callback is called once with file information
+extern int c_yd_client_file_info_async(c_yd_client_t *client, const char * path,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+// callback is called for every item and at last with NULL
+// file and NULL error when listing is finished - return
+// non-zero from callback to stop listing
+extern int c_yd_client_ls_async(c_yd_client_t *client, const char * path,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+extern int c_yd_client_ls_public_async(c_yd_client_t *client,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+extern int c_yd_client_public_ls_async(c_yd_client_t *client, const char * public_key,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+extern int c_yd_client_trash_ls_async(c_yd_client_t *client,
+		void * user_data, int(*callback)(const c_yd_file_t *file, void * user_data, const char * error));
+
+// upload and download - callbacks same as in functions above
+extern int c_yd_client_upload_file_async(
+		c_yd_client_t *client, FILE *fp, const char * path, bool overwrite,
+		void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_upload_data_async(
+		c_yd_client_t *client, void * data, size_t size, const char * path, bool overwrite,
+		void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_download_file_async(
+		c_yd_client_t *client, FILE *fp, const char * path,
+		void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_download_data_async(
+		c_yd_client_t *client, const char * path,
+		void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_download_public_resource_async(
+		c_yd_client_t *client, FILE *fp, const char * public_key,
+		void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+extern int c_yd_client_download_public_resource_data_async(
+		c_yd_client_t *client, const char * public_key,
+		void *user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), 
+		void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
+//free clients and keep-alive connections cached for
+//functions with access_token argument and shared
+//DNS/TLS session cache (if not in use)
+extern void c_yandex_disk_cleanup(void);
+
 // curl functions
 extern int curl_download_file(FILE *fp, const char * url, void * user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow)); 
 
+// download file with parallel range requests in streams number of 
+// connections by chunk_size bytes (0 - 8Mb) into preallocated file -
+// falls back to curl_download_file if server does not support ranges
+extern int curl_download_file_ranges(FILE *fp, const char * url, int streams, size_t chunk_size, void * user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
 extern size_t curl_download_data(const char * url, void * user_data, void (*callback)(void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow)); 
 
+extern int curl_download_stream(const char * url, void * user_data, int (*callback)(c_yd_stream_t *stream, const void *data, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
+
 extern int curl_upload_file(FILE *fp, const char * url, void *user_data, void (*callback)(FILE *fp, size_t size, void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
 
 extern int curl_upload_data(void * data, size_t size, const char * url, void *user_data, void (*callback)(void *data, size_t size,void *user_data, const char *error), void *clientp, int (*progress_callback)(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow));
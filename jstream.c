@@ -0,0 +1,354 @@
+/**
+ * File              : jstream.c
+ * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
+ * Date              : 17.10.2026
+ * Last Modified Date: 17.10.2026
+ * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "jstream.h"
+
+enum {
+	S_VALUE,         //value expected
+	S_VALUE_OR_END,  //value or ']' expected
+	S_KEY,           //key expected
+	S_KEY_OR_END,    //key or '}' expected
+	S_COLON,
+	S_AFTER,         //',' or end of container expected
+	S_DONE,          //document finished
+	S_STRING,
+	S_ESCAPE,
+	S_UNICODE,
+	S_NUMBER,
+	S_LITERAL,
+	S_ERROR
+};
+
+static const char *literals[] = {"true", "false", "null"};
+static const jstream_event_t literal_events[] =
+	{JSTREAM_TRUE, JSTREAM_FALSE, JSTREAM_NULL};
+
+void jstream_init(jstream_t *js, void *user_data,
+		int (*callback)(void *user_data, jstream_event_t event,
+			const char *value, size_t len))
+{
+	memset(js, 0, sizeof(jstream_t));
+	js->callback = callback;
+	js->user_data = user_data;
+	js->state = S_VALUE;
+}
+
+void jstream_free(jstream_t *js)
+{
+	free(js->buf);
+	js->buf = NULL;
+	js->len = js->size = 0;
+}
+
+static int jstream_put(jstream_t *js, char c)
+{
+	if (js->len + 1 >= js->size){
+		size_t size = js->size ? js->size * 2 : 256;
+		char *buf = realloc(js->buf, size);
+		if (!buf)
+			return -1;
+		js->buf = buf;
+		js->size = size;
+	}
+	js->buf[js->len++] = c;
+	return 0;
+}
+
+/* add unicode code point as UTF-8 */
+static int jstream_put_utf8(jstream_t *js, unsigned long c)
+{
+	char b[4];
+	int i, n;
+
+	if (c < 0x80){
+		b[0] = (char)c; n = 1;
+	} else if (c < 0x800){
+		b[0] = (char)(0xC0 | c >> 6); n = 2;
+	} else if (c < 0x10000){
+		b[0] = (char)(0xE0 | c >> 12); n = 3;
+	} else {
+		b[0] = (char)(0xF0 | c >> 18); n = 4;
+	}
+	for (i = n - 1; i > 0; --i, c >>= 6)
+		b[i] = (char)(0x80 | (c & 0x3F));
+	
+	for (i = 0; i < n; ++i)
+		if (jstream_put(js, b[i]))
+			return -1;
+	return 0;
+}
+
+/* high surrogate without low one */
+static int jstream_put_surrogate(jstream_t *js)
+{
+	if (!js->surrogate)
+		return 0;
+	js->surrogate = 0;
+	return jstream_put_utf8(js, 0xFFFD);
+}
+
+static int jstream_emit(jstream_t *js, jstream_event_t event)
+{
+	const char *value = "";
+	if (js->buf){
+		js->buf[js->len] = 0;
+		value = js->buf;
+	}
+	if (js->callback)
+		return js->callback(js->user_data, event, value, js->len);
+	return 0;
+}
+
+/* value finished */
+static void jstream_value_end(jstream_t *js)
+{
+	js->len = 0;
+	js->state = js->depth ? S_AFTER : S_DONE;
+}
+
+static int jstream_is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/* start of value - return non-zero on error */
+static int jstream_value_begin(jstream_t *js, char c)
+{
+	int i;
+	switch (c) {
+		case '{': case '[':
+			if (js->depth == JSTREAM_MAX_DEPTH)
+				return -1;
+			js->stack[js->depth++] = c;
+			js->state = c == '{' ? S_KEY_OR_END : S_VALUE_OR_END;
+			return jstream_emit(js,
+					c == '{' ? JSTREAM_OBJECT_BEGIN : JSTREAM_ARRAY_BEGIN);
+		case '"':
+			js->string_key = 0;
+			js->len = 0;
+			js->state = S_STRING;
+			return 0;
+		case '-': case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			js->len = 0;
+			js->state = S_NUMBER;
+			return jstream_put(js, c);
+		default:
+			for (i = 0; i < 3; ++i) {
+				if (c == literals[i][0]){
+					js->literal = i;
+					js->pos = 1;
+					js->state = S_LITERAL;
+					return 0;
+				}
+			}
+	}
+	return -1;
+}
+
+/* end of container - return non-zero on error */
+static int jstream_end(jstream_t *js, char c)
+{
+	if (!js->depth || js->stack[js->depth - 1] != (c == '}' ? '{' : '['))
+		return -1;
+	js->depth--;
+	js->len = 0;
+	jstream_value_end(js);
+	return jstream_emit(js,
+			c == '}' ? JSTREAM_OBJECT_END : JSTREAM_ARRAY_END);
+}
+
+static int jstream_hex(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+int jstream_feed(jstream_t *js, const char *data, size_t len)
+{
+	size_t i;
+	int ret = 0;
+
+	for (i = 0; i < len && !ret; ++i) {
+		char c = data[i];
+again:
+		switch (js->state) {
+			case S_VALUE:
+			case S_VALUE_OR_END:
+				if (jstream_is_space(c))
+					break;
+				if (c == ']' && js->state == S_VALUE_OR_END)
+					ret = jstream_end(js, c);
+				else
+					ret = jstream_value_begin(js, c);
+				break;
+
+			case S_KEY:
+			case S_KEY_OR_END:
+				if (jstream_is_space(c))
+					break;
+				if (c == '}' && js->state == S_KEY_OR_END)
+					ret = jstream_end(js, c);
+				else if (c == '"'){
+					js->string_key = 1;
+					js->len = 0;
+					js->state = S_STRING;
+				} else
+					ret = -1;
+				break;
+
+			case S_COLON:
+				if (jstream_is_space(c))
+					break;
+				if (c == ':')
+					js->state = S_VALUE;
+				else
+					ret = -1;
+				break;
+
+			case S_AFTER:
+				if (jstream_is_space(c))
+					break;
+				if (c == ',')
+					js->state = js->stack[js->depth - 1] == '{' ? S_KEY : S_VALUE;
+				else if (c == '}' || c == ']')
+					ret = jstream_end(js, c);
+				else
+					ret = -1;
+				break;
+
+			case S_DONE:
+				if (!jstream_is_space(c))
+					ret = -1;
+				break;
+
+			case S_STRING:
+				if (c == '"'){
+					int key = js->string_key;
+					ret = jstream_put_surrogate(js);
+					if (ret)
+						break;
+					if (key){
+						js->state = S_COLON;
+						ret = jstream_emit(js, JSTREAM_KEY);
+						js->len = 0;
+					} else {
+						ret = jstream_emit(js, JSTREAM_STRING);
+						jstream_value_end(js);
+					}
+				} else if (c == '\\')
+					js->state = S_ESCAPE;
+				else if ((unsigned char)c < 0x20)
+					ret = -1;
+				else {
+					ret = jstream_put_surrogate(js);
+					if (!ret)
+						ret = jstream_put(js, c);
+				}
+				break;
+
+			case S_ESCAPE:
+				js->state = S_STRING;
+				if (c == 'u'){
+					js->state = S_UNICODE;
+					js->unicode = 0;
+					js->hex = 4;
+					break;
+				}
+				switch (c) {
+					case '"': case '\\': case '/':    break;
+					case 'b':  c = '\b'; break;
+					case 'f':  c = '\f'; break;
+					case 'n':  c = '\n'; break;
+					case 'r':  c = '\r'; break;
+					case 't':  c = '\t'; break;
+					default:   ret = -1;
+				}
+				if (!ret)
+					ret = jstream_put_surrogate(js);
+				if (!ret)
+					ret = jstream_put(js, c);
+				break;
+
+			case S_UNICODE:
+				{
+					int h = jstream_hex(c);
+					if (h < 0){
+						ret = -1;
+						break;
+					}
+					js->unicode = js->unicode << 4 | h;
+					if (--js->hex)
+						break;
+					js->state = S_STRING;
+					if (js->unicode >= 0xD800 && js->unicode <= 0xDBFF){
+						// wait for low surrogate
+						ret = jstream_put_surrogate(js);
+						js->surrogate = js->unicode;
+					} else if (js->unicode >= 0xDC00 && js->unicode <= 0xDFFF){
+						unsigned long hi = js->surrogate;
+						js->surrogate = 0;
+						ret = jstream_put_utf8(js, hi ?
+								0x10000 + ((hi - 0xD800) << 10) + (js->unicode - 0xDC00) :
+								0xFFFD);
+					} else {
+						ret = jstream_put_surrogate(js);
+						if (!ret)
+							ret = jstream_put_utf8(js, js->unicode);
+					}
+				}
+				break;
+
+			case S_NUMBER:
+				if ((c >= '0' && c <= '9') || c == '.' ||
+						c == 'e' || c == 'E' || c == '+' || c == '-')
+				{
+					ret = jstream_put(js, c);
+					break;
+				}
+				ret = jstream_emit(js, JSTREAM_NUMBER);
+				jstream_value_end(js);
+				if (!ret)
+					goto again;
+				break;
+
+			case S_LITERAL:
+				if (c != literals[js->literal][js->pos]){
+					ret = -1;
+					break;
+				}
+				if (literals[js->literal][++js->pos] == 0){
+					ret = jstream_emit(js, literal_events[js->literal]);
+					jstream_value_end(js);
+				}
+				break;
+
+			default:
+				ret = -1;
+		}
+	}
+
+	if (ret)
+		js->state = S_ERROR;
+	return ret;
+}
+
+int jstream_finish(jstream_t *js)
+{
+	if (js->state == S_NUMBER && js->depth == 0){
+		int ret = jstream_emit(js, JSTREAM_NUMBER);
+		jstream_value_end(js);
+		if (ret)
+			return ret;
+	}
+	return js->state == S_DONE ? 0 : -1;
+}
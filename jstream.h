@@ -0,0 +1,70 @@
+/**
+ * File              : jstream.h
+ * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
+ * Date              : 17.10.2026
+ * Last Modified Date: 17.10.2026
+ * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
+ */
+
+/*
+ * Streaming JSON tokenizer - data is fed by chunks and
+ * callback is called for every token as soon as it is
+ * complete, no document tree is built
+ */
+
+#ifndef JSTREAM_H
+#define JSTREAM_H
+
+#include <stddef.h>
+
+#define JSTREAM_MAX_DEPTH 64
+
+typedef enum {
+	JSTREAM_OBJECT_BEGIN,
+	JSTREAM_OBJECT_END,
+	JSTREAM_ARRAY_BEGIN,
+	JSTREAM_ARRAY_END,
+	JSTREAM_KEY,      //value is unescaped key
+	JSTREAM_STRING,   //value is unescaped string
+	JSTREAM_NUMBER,   //value is number text
+	JSTREAM_TRUE,
+	JSTREAM_FALSE,
+	JSTREAM_NULL
+} jstream_event_t;
+
+typedef struct jstream_t {
+	// called for every token - value is null-terminated for
+	// keys, strings and numbers; return non-zero to stop
+	int (*callback)(void *user_data, jstream_event_t event,
+			const char *value, size_t len);
+	void *user_data;
+	int   depth;                       //number of open containers
+	char  stack[JSTREAM_MAX_DEPTH];    //'{' or '['
+	int   state;
+	int   string_key;                  //parsed string is key
+	int   literal;                     //index in true/false/null
+	int   pos;                         //parsed chars of literal
+	unsigned long unicode;             //\uXXXX code
+	unsigned long surrogate;           //high surrogate of pair
+	int   hex;                         //hex digits left in \uXXXX
+	char *buf;                         //token
+	size_t len;
+	size_t size;
+} jstream_t;
+
+/* init tokenizer */
+void jstream_init(jstream_t *js, void *user_data,
+		int (*callback)(void *user_data, jstream_event_t event,
+			const char *value, size_t len));
+
+/* parse next chunk - return 0 on success, -1 on syntax
+ * error or value returned from callback if it stopped */
+int jstream_feed(jstream_t *js, const char *data, size_t len);
+
+/* end of data - return 0 if document is complete */
+int jstream_finish(jstream_t *js);
+
+/* free memory of tokenizer */
+void jstream_free(jstream_t *js);
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * File              : md5.c
+ * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
+ * Date              : 17.10.2026
+ * Last Modified Date: 17.10.2026
+ * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
+ */
+
+#include <string.h>
+#include "md5.h"
+
+#define ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static const uint32_t K[64] = {
+	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+	0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+	0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+	0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+	0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const int R[64] = {
+	7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+	5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+	4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+	6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static void md5_block(md5_t *ctx, const unsigned char *p)
+{
+	uint32_t w[16], a, b, c, d, f, t;
+	int i, g;
+
+	// words are little-endian
+	for (i = 0; i < 16; ++i)
+		w[i] = (uint32_t)p[i*4] | (uint32_t)p[i*4+1] << 8 |
+		       (uint32_t)p[i*4+2] << 16 | (uint32_t)p[i*4+3] << 24;
+
+	a = ctx->state[0]; b = ctx->state[1]; c = ctx->state[2]; d = ctx->state[3];
+
+	for (i = 0; i < 64; ++i) {
+		if (i < 16){
+			f = (b & c) | (~b & d);
+			g = i;
+		} else if (i < 32){
+			f = (d & b) | (~d & c);
+			g = (5 * i + 1) % 16;
+		} else if (i < 48){
+			f = b ^ c ^ d;
+			g = (3 * i + 5) % 16;
+		} else {
+			f = c ^ (b | ~d);
+			g = (7 * i) % 16;
+		}
+		t = d; d = c; c = b;
+		b = b + ROL(a + f + K[i] + w[g], R[i]);
+		a = t;
+	}
+
+	ctx->state[0] += a; ctx->state[1] += b; ctx->state[2] += c; ctx->state[3] += d;
+}
+
+void md5_init(md5_t *ctx)
+{
+	ctx->state[0] = 0x67452301; ctx->state[1] = 0xefcdab89;
+	ctx->state[2] = 0x98badcfe; ctx->state[3] = 0x10325476;
+	ctx->count = 0;
+}
+
+void md5_update(md5_t *ctx, const void *data, size_t len)
+{
+	const unsigned char *p = data;
+	size_t used = ctx->count % 64;
+
+	ctx->count += len;
+
+	// fill not hashed block
+	if (used) {
+		size_t n = 64 - used;
+		if (n > len)
+			n = len;
+		memcpy(ctx->buf + used, p, n);
+		p += n; len -= n; used += n;
+		if (used < 64)
+			return;
+		md5_block(ctx, ctx->buf);
+	}
+
+	for (; len >= 64; p += 64, len -= 64)
+		md5_block(ctx, p);
+
+	memcpy(ctx->buf, p, len);
+}
+
+void md5_final(md5_t *ctx, unsigned char digest[MD5_DIGEST_LEN])
+{
+	uint64_t bits = ctx->count * 8;
+	size_t used = ctx->count % 64;
+	int i;
+
+	// padding and message length in bits (little-endian)
+	ctx->buf[used++] = 0x80;
+	if (used > 56) {
+		memset(ctx->buf + used, 0, 64 - used);
+		md5_block(ctx, ctx->buf);
+		used = 0;
+	}
+	memset(ctx->buf + used, 0, 56 - used);
+	for (i = 0; i < 8; ++i)
+		ctx->buf[56 + i] = (unsigned char)(bits >> (i * 8));
+	md5_block(ctx, ctx->buf);
+
+	for (i = 0; i < 4; ++i) {
+		digest[i*4]   = (unsigned char)(ctx->state[i]);
+		digest[i*4+1] = (unsigned char)(ctx->state[i] >> 8);
+		digest[i*4+2] = (unsigned char)(ctx->state[i] >> 16);
+		digest[i*4+3] = (unsigned char)(ctx->state[i] >> 24);
+	}
+}
@@ -0,0 +1,31 @@
+/**
+ * File              : md5.h
+ * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
+ * Date              : 17.10.2026
+ * Last Modified Date: 17.10.2026
+ * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
+ */
+
+/*
+ * MD5 hash (RFC 1321)
+ */
+
+#ifndef MD5_H
+#define MD5_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MD5_DIGEST_LEN 16
+
+typedef struct md5_t {
+	uint32_t      state[4];
+	uint64_t      count;     //number of hashed bytes
+	unsigned char buf[64];   //not hashed block
+} md5_t;
+
+void md5_init(md5_t *ctx);
+void md5_update(md5_t *ctx, const void *data, size_t len);
+void md5_final(md5_t *ctx, unsigned char digest[MD5_DIGEST_LEN]);
+
+#endif
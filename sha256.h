@@ -0,0 +1,31 @@
+/**
+ * File              : sha256.h
+ * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
+ * Date              : 16.10.2026
+ * Last Modified Date: 16.10.2026
+ * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
+ */
+
+/*
+ * SHA-256 hash (FIPS 180-4)
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_DIGEST_LEN 32
+
+typedef struct sha256_t {
+	uint32_t      state[8];
+	uint64_t      count;     //number of hashed bytes
+	unsigned char buf[64];   //not hashed block
+} sha256_t;
+
+void sha256_init(sha256_t *ctx);
+void sha256_update(sha256_t *ctx, const void *data, size_t len);
+void sha256_final(sha256_t *ctx, unsigned char digest[SHA256_DIGEST_LEN]);
+
+#endif
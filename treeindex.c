@@ -0,0 +1,678 @@
+/**
+ * File              : treeindex.c
+ * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
+ * Date              : 17.10.2026
+ * Last Modified Date: 17.10.2026
+ * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include "treeindex.h"
+
+#ifdef _WIN32
+
+/* memory-mapped index needs POSIX mmap */
+treeindex_t *treeindex_open(const char *filepath)
+{
+	errno = ENOSYS;
+	return NULL;
+}
+
+void treeindex_close(treeindex_t *ti) {}
+int treeindex_sync(treeindex_t *ti) { return -1; }
+int treeindex_put(treeindex_t *ti, const treeindex_item_t *item) { return -1; }
+int treeindex_set_children(treeindex_t *ti, const char *path,
+		const treeindex_item_t *items, int count) { return -1; }
+void treeindex_remove(treeindex_t *ti, const char *path) {}
+int treeindex_move(treeindex_t *ti, const char *from, const char *to,
+		int copy) { return -1; }
+int treeindex_get(treeindex_t *ti, const char *path,
+		treeindex_item_t *item) { return -1; }
+int treeindex_children(treeindex_t *ti, const char *path, void *user_data,
+		int (*callback)(const treeindex_item_t *item, void *user_data)) { return -1; }
+int treeindex_count(treeindex_t *ti) { return 0; }
+treeindex_int64_t treeindex_revision(treeindex_t *ti) { return 0; }
+void treeindex_set_revision(treeindex_t *ti, treeindex_int64_t revision) {}
+
+#else
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TI_MAGIC       "YDTI"
+#define TI_VERSION     1
+#define TI_MIN_SIZE    65536
+#define TI_MIN_BUCKETS 1024
+#define TI_PATH_MAX    65535
+#define TI_ALIGN(n)    (((n) + 7) & ~(size_t)7)
+
+/* start of file */
+struct ti_header {
+	char      magic[4];
+	uint32_t  version;
+	uint32_t  header_size;  //layout of file
+	uint32_t  record_size;
+	uint32_t  dirty;        //changed and not synced
+	uint32_t  count;        //records
+	uint32_t  buckets;      //size of hash table - power of 2
+	uint32_t  epoch;        //mark of last set_children
+	uint64_t  used;         //used bytes of file
+	uint64_t  dead;         //bytes of removed records and tables
+	uint64_t  table;        //offset of hash table
+	uint64_t  root;         //offset of "/" record
+	int64_t   revision;
+};
+
+/* resource - offsets link records in hash buckets and tree */
+struct ti_record {
+	uint64_t  hnext;        //next record of hash bucket
+	uint64_t  parent;
+	uint64_t  child;        //first item of directory
+	uint64_t  sibling;      //next item of parent
+	int64_t   size;
+	int64_t   modified;
+	uint32_t  hash;
+	uint32_t  mark;         //epoch when record was listed
+	uint16_t  len;          //length of path
+	uint8_t   dir;
+	uint8_t   listed;       //items of directory are known
+	char      md5[33];
+	char      sha256[65];
+	char      path[1];
+};
+
+struct treeindex {
+	int    fd;
+	char  *map;
+	size_t size;            //size of mapping
+	char  *filepath;
+};
+
+#define H(ti)      ((struct ti_header *)(ti)->map)
+#define R(ti, off) ((struct ti_record *)((ti)->map + (off)))
+#define TABLE(ti)  ((uint64_t *)((ti)->map + H(ti)->table))
+#define TI_RECORD_SIZE(len) \
+	TI_ALIGN(offsetof(struct ti_record, path) + (len) + 1)
+
+/* grow file to size and map it - pointers to old mapping are
+ * not valid; old mapping is kept on error */
+static int ti_map(treeindex_t *ti, size_t size)
+{
+	char *map;
+
+	if (ftruncate(ti->fd, size))
+		return -1;
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, ti->fd, 0);
+	if (map == MAP_FAILED)
+		return -1; //file may stay bigger than mapping
+	if (ti->map)
+		munmap(ti->map, ti->size);
+	ti->map = map;
+	ti->size = size;
+	return 0;
+}
+
+/* allocate zeroed bytes - return offset or 0 on error; file
+ * may be mapped again */
+static uint64_t ti_alloc(treeindex_t *ti, size_t n)
+{
+	uint64_t off;
+
+	n = TI_ALIGN(n);
+	if (H(ti)->used + n > ti->size){
+		size_t size = ti->size;
+		while (size < H(ti)->used + n)
+			size *= 2;
+		if (ti_map(ti, size))
+			return 0;
+	}
+	off = H(ti)->used;
+	H(ti)->used += n;
+	memset(ti->map + off, 0, n);
+	return off;
+}
+
+/* mark file changed - damaged index is not opened after crash */
+static void ti_touch(treeindex_t *ti)
+{
+	if (H(ti)->dirty)
+		return;
+	H(ti)->dirty = 1;
+	msync(ti->map, sizeof(struct ti_header), MS_SYNC);
+}
+
+static uint32_t ti_hash(const char *path, size_t len)
+{
+	// FNV-1a
+	uint32_t hash = 2166136261U;
+	size_t i;
+	for (i = 0; i < len; ++i)
+		hash = (hash ^ (unsigned char)path[i]) * 16777619U;
+	return hash;
+}
+
+/* absolute path without trailing slash - return length or -1 */
+static int ti_path_len(const char *path)
+{
+	size_t len;
+	if (!path || path[0] != '/')
+		return -1;
+	len = strlen(path);
+	if (len > TI_PATH_MAX || (len > 1 && path[len - 1] == '/'))
+		return -1;
+	return (int)len;
+}
+
+/* length of parent path */
+static size_t ti_parent_len(const char *path, size_t len)
+{
+	while (len > 0 && path[len - 1] != '/')
+		len--;
+	return len > 1 ? len - 1 : 1;
+}
+
+static uint64_t ti_find(treeindex_t *ti, const char *path, size_t len)
+{
+	uint32_t hash = ti_hash(path, len);
+	uint64_t off = TABLE(ti)[hash & (H(ti)->buckets - 1)];
+
+	for (; off; off = R(ti, off)->hnext) {
+		struct ti_record *r = R(ti, off);
+		if (r->hash == hash && r->len == len &&
+				memcmp(r->path, path, len) == 0)
+			return off;
+	}
+	return 0;
+}
+
+/* double hash table - old table is left in file */
+static int ti_rehash(treeindex_t *ti)
+{
+	uint32_t i, buckets = H(ti)->buckets;
+	uint64_t off, *table, *old;
+
+	off = ti_alloc(ti, buckets * 2 * sizeof(uint64_t));
+	if (!off)
+		return -1;
+	old = TABLE(ti);
+	table = (uint64_t *)(ti->map + off);
+	for (i = 0; i < buckets; ++i) {
+		uint64_t r = old[i];
+		while (r) {
+			uint64_t next = R(ti, r)->hnext;
+			uint32_t b = R(ti, r)->hash & (buckets * 2 - 1);
+			R(ti, r)->hnext = table[b];
+			table[b] = r;
+			r = next;
+		}
+	}
+	H(ti)->dead += buckets * sizeof(uint64_t);
+	H(ti)->table = off;
+	H(ti)->buckets = buckets * 2;
+	return 0;
+}
+
+/* new record - path should not point to index memory */
+static uint64_t ti_insert(
+		treeindex_t *ti, const char *path, size_t len, uint64_t parent)
+{
+	struct ti_record *r;
+	uint64_t off;
+	uint32_t b;
+
+	if (H(ti)->count >= H(ti)->buckets && ti_rehash(ti))
+		return 0;
+	off = ti_alloc(ti, TI_RECORD_SIZE(len));
+	if (!off)
+		return 0;
+
+	r = R(ti, off);
+	r->hash = ti_hash(path, len);
+	r->len = (uint16_t)len;
+	memcpy(r->path, path, len);
+	r->path[len] = 0;
+	r->parent = parent;
+	r->mark = H(ti)->epoch;
+
+	b = r->hash & (H(ti)->buckets - 1);
+	r->hnext = TABLE(ti)[b];
+	TABLE(ti)[b] = off;
+	if (parent){
+		r->sibling = R(ti, parent)->child;
+		R(ti, parent)->child = off;
+	}
+	H(ti)->count++;
+	return off;
+}
+
+/* find or add record with parent directories */
+static uint64_t ti_add(treeindex_t *ti, const char *path, size_t len, int dir)
+{
+	uint64_t off = ti_find(ti, path, len), parent = 0;
+
+	if (off){
+		if (dir)
+			R(ti, off)->dir = 1;
+		return off;
+	}
+	if (len > 1){
+		parent = ti_add(ti, path, ti_parent_len(path, len), 1);
+		if (!parent)
+			return 0;
+	}
+	off = ti_insert(ti, path, len, parent);
+	if (!off)
+		return 0;
+	R(ti, off)->dir = dir ? 1 : 0;
+	if (len == 1)
+		H(ti)->root = off;
+	return off;
+}
+
+static void ti_unlink_hash(treeindex_t *ti, uint64_t off)
+{
+	uint64_t *p = &TABLE(ti)[R(ti, off)->hash & (H(ti)->buckets - 1)];
+	while (*p != off)
+		p = &R(ti, *p)->hnext;
+	*p = R(ti, off)->hnext;
+}
+
+static void ti_unlink_parent(treeindex_t *ti, uint64_t off)
+{
+	uint64_t *p, parent = R(ti, off)->parent;
+	if (!parent)
+		return;
+	p = &R(ti, parent)->child;
+	while (*p != off)
+		p = &R(ti, *p)->sibling;
+	*p = R(ti, off)->sibling;
+}
+
+/* free record and subtree - record is unlinked from parent */
+static void ti_free_tree(treeindex_t *ti, uint64_t off)
+{
+	uint64_t c = R(ti, off)->child;
+	while (c) {
+		uint64_t next = R(ti, c)->sibling;
+		ti_free_tree(ti, c);
+		c = next;
+	}
+	ti_unlink_hash(ti, off);
+	if (off == H(ti)->root)
+		H(ti)->root = 0;
+	H(ti)->count--;
+	H(ti)->dead += TI_RECORD_SIZE(R(ti, off)->len);
+}
+
+static void ti_remove(treeindex_t *ti, uint64_t off)
+{
+	ti_unlink_parent(ti, off);
+	ti_free_tree(ti, off);
+}
+
+static void ti_set(struct ti_record *r, const treeindex_item_t *item)
+{
+	r->dir = item->dir ? 1 : 0;
+	if (!item->dir)
+		r->listed = 0;
+	else if (item->listed)
+		r->listed = 1;
+	r->size = item->size;
+	r->modified = item->modified;
+	snprintf(r->md5, sizeof(r->md5), "%s", item->md5 ? item->md5 : "");
+	snprintf(r->sha256, sizeof(r->sha256), "%s", item->sha256 ? item->sha256 : "");
+}
+
+static void ti_item(treeindex_t *ti, uint64_t off, treeindex_item_t *item)
+{
+	struct ti_record *r = R(ti, off);
+	item->path = r->path;
+	item->dir = r->dir;
+	item->listed = r->listed;
+	item->size = r->size;
+	item->modified = r->modified;
+	item->md5 = r->md5;
+	item->sha256 = r->sha256;
+}
+
+static int ti_put(treeindex_t *ti, const treeindex_item_t *item)
+{
+	int len = ti_path_len(item->path);
+	uint64_t off;
+
+	if (len < 0)
+		return -1;
+	off = ti_add(ti, item->path, len, item->dir);
+	if (!off)
+		return -1;
+	if (R(ti, off)->child && !item->dir){
+		// directory is replaced with file
+		uint64_t c = R(ti, off)->child;
+		R(ti, off)->child = 0;
+		while (c) {
+			uint64_t next = R(ti, c)->sibling;
+			ti_free_tree(ti, c);
+			c = next;
+		}
+	}
+	ti_set(R(ti, off), item);
+	R(ti, off)->mark = H(ti)->epoch;
+	return 0;
+}
+
+/* empty index in file */
+static int ti_init(treeindex_t *ti)
+{
+	struct ti_header *h;
+
+	if (ti->map)
+		munmap(ti->map, ti->size);
+	ti->map = NULL;
+	if (ftruncate(ti->fd, 0) || ti_map(ti, TI_MIN_SIZE))
+		return -1;
+
+	h = H(ti);
+	memcpy(h->magic, TI_MAGIC, 4);
+	h->version = TI_VERSION;
+	h->header_size = sizeof(struct ti_header);
+	h->record_size = offsetof(struct ti_record, path);
+	h->used = TI_ALIGN(sizeof(struct ti_header));
+	h->buckets = TI_MIN_BUCKETS;
+	h->table = ti_alloc(ti, TI_MIN_BUCKETS * sizeof(uint64_t));
+	if (!h->table || !ti_add(ti, "/", 1, 1))
+		return -1;
+	return 0;
+}
+
+/* map index file - return non-zero if file is not valid index */
+static int ti_load(treeindex_t *ti)
+{
+	struct stat st;
+	struct ti_header *h;
+
+	if (fstat(ti->fd, &st) || (size_t)st.st_size < TI_MIN_SIZE)
+		return -1;
+	ti->map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, ti->fd, 0);
+	if (ti->map == MAP_FAILED){
+		ti->map = NULL;
+		return -1;
+	}
+	ti->size = st.st_size;
+
+	h = H(ti);
+	if (memcmp(h->magic, TI_MAGIC, 4) || h->version != TI_VERSION ||
+			h->header_size != sizeof(struct ti_header) ||
+			h->record_size != offsetof(struct ti_record, path) ||
+			h->dirty || h->used > ti->size || !h->buckets ||
+			(h->buckets & (h->buckets - 1)) ||
+			h->table + h->buckets * sizeof(uint64_t) > h->used)
+		return -1;
+	return 0;
+}
+
+static treeindex_t *ti_open(const char *filepath, int flags)
+{
+	treeindex_t *ti = calloc(1, sizeof(treeindex_t));
+	if (!ti)
+		return NULL;
+	ti->filepath = strdup(filepath);
+	ti->fd = open(filepath, O_RDWR | O_CREAT | flags, 0644);
+	if (!ti->filepath || ti->fd < 0){
+		free(ti->filepath);
+		free(ti);
+		return NULL;
+	}
+	if (ti_load(ti) && ti_init(ti)){
+		treeindex_close(ti);
+		return NULL;
+	}
+	return ti;
+}
+
+treeindex_t *treeindex_open(const char *filepath)
+{
+	return ti_open(filepath, 0);
+}
+
+/* add record of other index with subtree */
+static int ti_copy_tree(treeindex_t *dst, treeindex_t *src, uint64_t off)
+{
+	treeindex_item_t item;
+	uint64_t c;
+
+	ti_item(src, off, &item);
+	if (ti_put(dst, &item))
+		return -1;
+	for (c = R(src, off)->child; c; c = R(src, c)->sibling)
+		if (ti_copy_tree(dst, src, c))
+			return -1;
+	return 0;
+}
+
+/* write live records to new file and replace index with it */
+static int ti_compact(treeindex_t *ti)
+{
+	treeindex_t *tmp;
+	char *tmppath = malloc(strlen(ti->filepath) + 5);
+	int ret = -1;
+
+	if (!tmppath)
+		return -1;
+	sprintf(tmppath, "%s.tmp", ti->filepath);
+	tmp = ti_open(tmppath, O_TRUNC);
+	if (tmp){
+		H(tmp)->revision = H(ti)->revision;
+		if ((!H(ti)->root || ti_copy_tree(tmp, ti, H(ti)->root) == 0) &&
+				treeindex_sync(tmp) == 0)
+			ret = 0;
+		treeindex_close(tmp);
+	}
+	if (ret == 0 && rename(tmppath, ti->filepath) == 0){
+		// use new file
+		munmap(ti->map, ti->size);
+		ti->map = NULL;
+		close(ti->fd);
+		ti->fd = open(ti->filepath, O_RDWR);
+		if (ti->fd < 0 || (ti_load(ti) && ti_init(ti)))
+			ret = -1;
+	} else {
+		unlink(tmppath);
+		ret = -1;
+	}
+	free(tmppath);
+	return ret;
+}
+
+int treeindex_sync(treeindex_t *ti)
+{
+	if (!ti->map)
+		return -1;
+	if (!H(ti)->dirty)
+		return 0;
+	if (H(ti)->dead > H(ti)->used / 2 && H(ti)->used > TI_MIN_SIZE &&
+			ti_compact(ti) == 0)
+		return 0;
+	if (msync(ti->map, ti->size, MS_SYNC))
+		return -1;
+	H(ti)->dirty = 0;
+	return msync(ti->map, sizeof(struct ti_header), MS_SYNC);
+}
+
+void treeindex_close(treeindex_t *ti)
+{
+	if (!ti)
+		return;
+	if (ti->map){
+		treeindex_sync(ti);
+		munmap(ti->map, ti->size);
+	}
+	if (ti->fd >= 0)
+		close(ti->fd);
+	free(ti->filepath);
+	free(ti);
+}
+
+int treeindex_put(treeindex_t *ti, const treeindex_item_t *item)
+{
+	ti_touch(ti);
+	return ti_put(ti, item);
+}
+
+int treeindex_set_children(treeindex_t *ti, const char *path,
+		const treeindex_item_t *items, int count)
+{
+	int i, len = ti_path_len(path), ret = 0;
+	uint64_t off, c;
+
+	if (len < 0)
+		return -1;
+	ti_touch(ti);
+	H(ti)->epoch++;
+	if (!(off = ti_add(ti, path, len, 1)))
+		return -1;
+	R(ti, off)->listed = 1;
+	for (i = 0; i < count; ++i)
+		if (ti_put(ti, &items[i]))
+			ret = -1;
+
+	// remove items which are not listed
+	off = ti_find(ti, path, len);
+	for (c = R(ti, off)->child; c; ) {
+		uint64_t next = R(ti, c)->sibling;
+		if (R(ti, c)->mark != H(ti)->epoch)
+			ti_remove(ti, c);
+		c = next;
+	}
+	return ret;
+}
+
+void treeindex_remove(treeindex_t *ti, const char *path)
+{
+	int len = ti_path_len(path);
+	uint64_t off;
+
+	if (len < 0 || !(off = ti_find(ti, path, len)))
+		return;
+	ti_touch(ti);
+	ti_remove(ti, off);
+}
+
+/* copy record with subtree to path in buf */
+static int ti_copy(treeindex_t *ti, uint64_t src, char *buf, size_t len)
+{
+	treeindex_item_t item;
+	char md5[33], sha256[65];
+	uint64_t c;
+
+	// strings of index memory are not valid after put
+	ti_item(ti, src, &item);
+	item.path = buf;
+	item.md5 = strcpy(md5, item.md5);
+	item.sha256 = strcpy(sha256, item.sha256);
+	if (ti_put(ti, &item))
+		return -1;
+
+	for (c = R(ti, src)->child; c; c = R(ti, c)->sibling) {
+		struct ti_record *r = R(ti, c);
+		size_t n = ti_parent_len(r->path, r->len);
+		size_t l = len;
+
+		// name of child
+		n = r->len - (n > 1 ? n + 1 : 1);
+		if (len > 1)
+			buf[l++] = '/';
+		if (l + n > TI_PATH_MAX)
+			return -1;
+		memcpy(buf + l, r->path + r->len - n, n);
+		buf[l + n] = 0;
+		if (ti_copy(ti, c, buf, l + n))
+			return -1;
+		buf[len] = 0;
+	}
+	return 0;
+}
+
+int treeindex_move(treeindex_t *ti, const char *from, const char *to,
+		int copy)
+{
+	int flen = ti_path_len(from), tlen = ti_path_len(to), ret;
+	uint64_t src, dst;
+	char *buf;
+
+	if (flen < 0 || tlen < 0)
+		return -1;
+	// check before destination is removed - it may hold source
+	if (flen == 1 || tlen == 1 || strcmp(from, to) == 0 ||
+			(strncmp(to, from, flen) == 0 && to[flen] == '/') ||
+			(strncmp(from, to, tlen) == 0 && from[tlen] == '/') ||
+			!ti_find(ti, from, flen))
+		return -1;
+	ti_touch(ti);
+	if ((dst = ti_find(ti, to, tlen)))
+		ti_remove(ti, dst);
+	src = ti_find(ti, from, flen);
+	if (!src)
+		return -1;
+
+	buf = malloc(TI_PATH_MAX + 1);
+	if (!buf)
+		return -1;
+	strcpy(buf, to);
+	ret = ti_copy(ti, src, buf, tlen);
+	free(buf);
+	if (!copy && (src = ti_find(ti, from, flen)))
+		ti_remove(ti, src);
+	return ret;
+}
+
+int treeindex_get(treeindex_t *ti, const char *path, treeindex_item_t *item)
+{
+	int len = ti_path_len(path);
+	uint64_t off;
+
+	if (len < 0 || !(off = ti_find(ti, path, len)))
+		return -1;
+	ti_item(ti, off, item);
+	return 0;
+}
+
+int treeindex_children(treeindex_t *ti, const char *path, void *user_data,
+		int (*callback)(const treeindex_item_t *item, void *user_data))
+{
+	int len = ti_path_len(path), count = 0;
+	treeindex_item_t item;
+	uint64_t off, c;
+
+	if (len < 0 || !(off = ti_find(ti, path, len)) || !R(ti, off)->listed)
+		return -1;
+	for (c = R(ti, off)->child; c; c = R(ti, c)->sibling) {
+		count++;
+		ti_item(ti, c, &item);
+		if (callback && callback(&item, user_data))
+			break;
+	}
+	return count;
+}
+
+int treeindex_count(treeindex_t *ti)
+{
+	return H(ti)->count - (H(ti)->root ? 1 : 0);
+}
+
+treeindex_int64_t treeindex_revision(treeindex_t *ti)
+{
+	return H(ti)->revision;
+}
+
+void treeindex_set_revision(treeindex_t *ti, treeindex_int64_t revision)
+{
+	ti_touch(ti);
+	H(ti)->revision = revision;
+}
+
+#endif
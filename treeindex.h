@@ -0,0 +1,89 @@
+/**
+ * File              : treeindex.h
+ * Author            : Igor V. Sementsov <ig.kuzm@gmail.com>
+ * Date              : 17.10.2026
+ * Last Modified Date: 17.10.2026
+ * Last Modified By  : Igor V. Sementsov <ig.kuzm@gmail.com>
+ */
+
+/*
+ * Index of tree of files in memory-mapped file - records
+ * are found by hash of path and linked to parent directory,
+ * file is used as it is without parsing. Changes are written
+ * in place, index is compacted when half of file is free.
+ * Index is not thread-safe and is not shared between
+ * processes; file is not portable between architectures.
+ */
+
+#ifndef TREEINDEX_H
+#define TREEINDEX_H
+
+#include <stddef.h>
+
+#if defined(_MSC_VER) && _MSC_VER < 1600
+typedef __int64 treeindex_int64_t;
+#else
+#include <stdint.h>
+typedef int64_t treeindex_int64_t;
+#endif
+
+typedef struct treeindex treeindex_t;
+
+/* resource - path is absolute ("/dir/file") without trailing
+ * slash, strings of found items point to index memory and are
+ * valid until index is changed */
+typedef struct treeindex_item_t {
+	const char        *path;
+	int                dir;        //directory
+	int                listed;     //items of directory are known
+	treeindex_int64_t  size;
+	treeindex_int64_t  modified;   //unix time
+	const char        *md5;        //"" if not known
+	const char        *sha256;
+} treeindex_item_t;
+
+/* open or create index - index is created again if file is
+ * damaged or was not closed; return NULL on error (errno) */
+treeindex_t *treeindex_open(const char *filepath);
+
+/* write changes and close index */
+void treeindex_close(treeindex_t *ti);
+
+/* write changes to file - return 0 on success */
+int treeindex_sync(treeindex_t *ti);
+
+/* add or change resource - parent directories are added;
+ * return 0 on success */
+int treeindex_put(treeindex_t *ti, const treeindex_item_t *item);
+
+/* replace items of directory and mark it listed - items not
+ * in list are removed with subtrees; return 0 on success */
+int treeindex_set_children(treeindex_t *ti, const char *path,
+		const treeindex_item_t *items, int count);
+
+/* remove resource and its subtree */
+void treeindex_remove(treeindex_t *ti, const char *path);
+
+/* move or copy resource with subtree - destination is replaced;
+ * return 0 on success or -1 if source is not in index or one 
+ * path is inside other */
+int treeindex_move(treeindex_t *ti, const char *from, const char *to,
+		int copy);
+
+/* get resource - return 0 if found */
+int treeindex_get(treeindex_t *ti, const char *path, treeindex_item_t *item);
+
+/* pass items of directory to callback (index should not be
+ * changed in callback) - return number of items or -1 if
+ * items of directory are not known */
+int treeindex_children(treeindex_t *ti, const char *path, void *user_data,
+		int (*callback)(const treeindex_item_t *item, void *user_data));
+
+/* number of resources */
+int treeindex_count(treeindex_t *ti);
+
+/* application value kept in index (revision of disk) */
+treeindex_int64_t treeindex_revision(treeindex_t *ti);
+void treeindex_set_revision(treeindex_t *ti, treeindex_int64_t revision);
+
+#endif
@@ -139,6 +139,22 @@ SOURCE=cYandexDisk.def
 
 SOURCE=..\uuid4.c
 # End Source File
+# Begin Source File
+
+SOURCE=..\sha256.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\md5.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\jstream.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\treeindex.c
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
@@ -149,6 +165,10 @@ SOURCE=..\alloc.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\arena.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\cJSON.h
 # End Source File
 # Begin Source File
@@ -157,14 +177,30 @@ SOURCE=..\cYandexDisk.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\jstream.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\log.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\sha256.h
+# End Source File
+# Begin Source File
+
+SOURCE=..\md5.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\str.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\treeindex.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\uuid4.h
 # End Source File
 # End Group